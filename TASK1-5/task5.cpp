@@ -4,6 +4,11 @@
 #include <string> // 문자열 처리
 #include <iomanip> // 포매팅
 #include <vector>
+#include <optional>
+#include <chrono> // 시간 측정
+#include <cstdlib> // strtol
+#include <cerrno>
+#include <climits>
 using namespace std;
 
 #define START_ADDRESS "000000"
@@ -104,95 +109,124 @@ public:
  */
 class ReadOptab {
 private:
-    static const int TABLE_SIZE = 61; // 총 명령어 갯수와 가까운 소수로 설정
-    
-    /** 
-     * 해시 테이블 노드
+    static const size_t INITIAL_CAPACITY = 128; // 2의 거듭제곱. 명령어 59개 기준 적재율 0.5 이하
+
+    /**
+     * 해시 테이블 슬롯 (open addressing, 선형 탐사)
+     * 해시 값을 함께 저장해 문자열 비교 전에 걸러냄
      */
-    struct Node {
+    struct Slot {
         string key; // 키
         string value; // 값
-        Node* next; // 다음 노드
-        Node(const string& k, const string& v) : key(k), value(v), next(nullptr) {}
+        uint32_t hash = 0; // key의 해시 값
+        bool used = false; // 사용 여부
     };
 
-    Node* hashTab[TABLE_SIZE] = { nullptr };
+    vector<Slot> slots = vector<Slot>(INITIAL_CAPACITY);
+    size_t count = 0; // 저장된 원소 수
 
     /**
-     * hash function
-     * 
-     * Mnemonic code의 ASCII 값을 더하고 테이블 사이즈로 나누어서 인덱스 반환
+     * hash function (FNV-1a, 32비트)
+     *
      * @param key - Mnemonic
-     * @return - 노드 (Mnemonic, code)가 저장될 인덱스
+     * @return - key의 해시 값. 인덱스는 (해시 & (용량-1))
+     */
+    static uint32_t hash(const string& key) {
+        uint32_t h = 2166136261u;
+        for (unsigned char c : key) {
+            h ^= c;
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    /**
+     * key가 있는 슬롯, 없으면 key가 들어갈 빈 슬롯의 인덱스 반환
      */
-    int hash(const string& key) const {
-        int sum = 0;
-        for (char c : key) {
-            sum += int(c);
+    size_t findSlot(const string& key, uint32_t h) const {
+        size_t mask = slots.size() - 1;
+        size_t idx = h & mask;
+        while (slots[idx].used && !(slots[idx].hash == h && slots[idx].key == key)) {
+            idx = (idx + 1) & mask;
+        }
+        return idx;
+    }
+
+    /**
+     * 용량을 두 배로 늘리고 모든 원소를 다시 배치
+     */
+    void grow() {
+        vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        for (auto& slot : old) {
+            if (slot.used) slots[findSlot(slot.key, slot.hash)] = move(slot);
         }
-        return abs(sum) % TABLE_SIZE;
     }
 
     /**
      * hash table에 원소 삽입
-     * 
+     * 적재율이 0.5를 넘으면 테이블을 키움
+     *
      * @param key - 입력할 원소의 Mnemonic
      * @param value - 입력할 원소의 opcode
      */
     void put(const string& key, const string& value) {
-        int idx = hash(key);
-
-        // 중복된 인덱스가 있는지 검사
-        Node* head = hashTab[idx];
-        for (Node* n = head; n != nullptr; n = n->next) {
-            if (n->key == key) {  // 이미 존재하는 key라면 value 업데이트
-                n->value = value;
-                return;
-            }
+        if ((count + 1) * 2 > slots.size()) grow();
+        uint32_t h = hash(key);
+        Slot& slot = slots[findSlot(key, h)];
+        if (slot.used) { // 이미 존재하는 key라면 value 업데이트
+            slot.value = value;
+            return;
         }
-        // 새로운 노드를 삽입. 중복된 노드가 있다면 꼬리에 붙이고, 없다면 null을 next에 넣는 것
-        Node* newNode = new Node(key, value);
-        newNode->next = head;
-        hashTab[idx] = newNode;
+        slot.key = key;
+        slot.value = value;
+        slot.hash = h;
+        slot.used = true;
+        ++count;
     }
 
 public:
     /**
-     * 소멸자
-     * 메모리 해제
+     * hash table에서 key를 바탕으로 value를 찾음
+     * 어셈블러 지시자는 opcode가 없으므로 빈 문자열을 반환
+     *
+     * @param key - Mnemonic
+     * @return value - key에 대응되는 opcode. 명령어도 지시자도 아니면 nullopt
      */
-    ~ReadOptab() {
-        for (int i = 0; i < TABLE_SIZE; ++i) {
-            Node* curr = hashTab[i];
-            while (curr) {
-                Node* temp = curr;
-                curr = curr->next;
-                delete temp;
+    optional<string> tryGet(const string& key) const {
+        const Slot& slot = slots[findSlot(key, hash(key))];
+        if (slot.used) return slot.value;
+        for (const string& dir : directive) {
+            if (dir == key) {
+                return string();
             }
         }
+        return nullopt;
     }
 
     /**
      * hash table에서 key를 바탕으로 value를 리턴
-     * 
+     * 없는 명령어가 치명적인 경우에만 사용. 단순 검사는 tryGet 사용
+     *
      * @param key - Mnemonic
      * @return value - key에 대응되는 opcode
-     * @throws NotFoundMnemonicException 
+     * @throws NotFoundMnemonicException
      */
     string get(const string& key) const {
-        int idx = hash(key);
+        optional<string> value = tryGet(key);
+        if (!value) throw NotFoundMnemonicException("Mnemonic '" + key + "'은(는) 존재하지 않는 명령어입니다.");
+        return *value;
+    }
 
-        for (Node* n = hashTab[idx]; n != nullptr; n = n->next) {
-            if (n->key == key)
-                return n->value;
-        }
-        for (int i = 0; i < directive.size(); i++) {
-            if (directive[i] == key) {
-                return "";
-            }
+    /**
+     * 저장된 모든 Mnemonic 반환
+     */
+    vector<string> keys() const {
+        vector<string> result;
+        for (const auto& slot : slots) {
+            if (slot.used) result.push_back(slot.key);
         }
-
-        throw NotFoundMnemonicException("Mnemonic '" + key + "'은(는) 존재하지 않는 명령어입니다.");
+        return result;
     }
 
     /**
@@ -286,23 +320,8 @@ vector<Line> readSource(const string& srcName, ReadOptab& optab) {
                 string first = tokens[0];
                 string second = tokens[1];
 
-                bool firstIsOperation = false;
-
-                // Mnemonic인지 검사
-                try {
-                    optab.get(first); // 만약 optab에 존재한다면 operation
-                    firstIsOperation = true;
-                } catch(const NotFoundMnemonicException& e) { // 만약 optab에 존재하지 않는다면
-                    // 에러 catch 후 firstIsOperation = false 유지
-                }
-                
-                // 어셈블러 지시자인지 검사
-                for (const string& dir : directive) {
-                    if (dir == first) { // 어셈블러 지시자라면
-                        firstIsOperation = true;
-                        break;
-                    }
-                }
+                // Mnemonic 또는 어셈블러 지시자인지 검사
+                bool firstIsOperation = optab.tryGet(first).has_value();
 
                 if (firstIsOperation) { // first가 operation이라면 -> ___ operation operand
                     label = "";
@@ -325,10 +344,10 @@ vector<Line> readSource(const string& srcName, ReadOptab& optab) {
             }
 
             string opcode;
-            try {
-                opcode = optab.get(operation);
-            } catch(const exception& e) {
-                cout << e.what() << endl;
+            if (optional<string> found = optab.tryGet(operation)) {
+                opcode = *found;
+            } else {
+                cout << "Mnemonic '" << operation << "'은(는) 존재하지 않는 명령어입니다." << endl;
             }
 
             lines.emplace_back(formatNumber(index), "", label, operation, opcode, operand);
@@ -393,12 +412,69 @@ void outFile(const string& outputName, const vector<Line>& lines) {
     outFile.close();
 }
 
-int main() {
+/**
+ * OPTAB 검색 시간 측정 (task5 -b 반복횟수)
+ * 명령어(hit)와 레이블(miss)을 찾는 데 걸린 검색당 시간을
+ * tryGet과 예외를 잡는 get 방식으로 각각 출력
+ * @param optab
+ * @param iterations 키 목록 전체를 검색하는 횟수
+ */
+void benchmarkLookup(const ReadOptab& optab, int iterations) {
+    vector<string> hits = optab.keys();
+    vector<string> misses = {"FIRST", "CLOOP", "ENDFIL", "EOF", "THREE", "ZERO", "RETADR", "LENGTH", "BUFFER", "RDREC"};
+    size_t found = 0; // 검색 결과를 사용해 최적화로 사라지지 않도록 함
+
+    // 검색 한 번당 평균 시간(ns). 찾을 키가 없으면(OPTAB이 비었으면) "-"
+    auto measure = [&](const vector<string>& keys, auto lookup) {
+        if (keys.empty()) return string("-");
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            for (const string& key : keys) found += lookup(key);
+        }
+        chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+        ostringstream ss;
+        ss << fixed << setprecision(1) << elapsed.count() / (double(iterations) * keys.size());
+        return ss.str();
+    };
+    auto byTryGet = [&](const string& key) { return optab.tryGet(key).has_value() ? 1 : 0; };
+    auto byGet = [&](const string& key) {
+        try {
+            optab.get(key);
+            return 1;
+        } catch (const NotFoundMnemonicException& e) {
+            return 0;
+        }
+    };
+
+    cout << left << setw(10) << "LOOKUP" << setw(14) << "HIT(ns)" << setw(14) << "MISS(ns)" << "\n";
+    cout << left << setw(10) << "tryGet" << setw(14) << measure(hits, byTryGet) << setw(14) << measure(misses, byTryGet) << "\n";
+    cout << left << setw(10) << "get" << setw(14) << measure(hits, byGet) << setw(14) << measure(misses, byGet) << "\n";
+    cout << "(" << hits.size() << " mnemonics, " << misses.size() << " labels, found " << found << ")" << endl;
+    if (hits.empty()) cout << "OPTAB이 비어 있어 HIT는 측정하지 않았습니다." << endl;
+}
+
+int main(int argc, char* argv[]) {
     ReadOptab optab;
 
     // OPTAB 읽기
     optab.loadOptab("optab.txt");
 
+    // -b [반복횟수]: OPTAB 검색 시간 측정
+    if (argc >= 2 && string(argv[1]) == "-b") {
+        long iterations = 100000;
+        if (argc >= 3) {
+            char* end = nullptr;
+            errno = 0;
+            iterations = strtol(argv[2], &end, 10);
+            if (end == argv[2] || *end != '\0' || errno == ERANGE || iterations <= 0 || iterations > INT_MAX) {
+                cerr << "사용법: task5 -b [반복횟수(양의 정수)]" << endl;
+                return 2;
+            }
+        }
+        benchmarkLookup(optab, (int)iterations);
+        return 0;
+    }
+
     // 사용자로부터 입력 받기
     cout << "\n입력('프로그램명' '소스파일명' '출력파일명'): ";
     string input;
@@ -0,0 +1,378 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+// 문자열 앞뒤 공백 제거
+static inline string trim(const string &s) {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == string::npos) return "";
+    size_t b = s.find_last_not_of(" \t\r\n");
+    return s.substr(a, b - a + 1);
+}
+// 공백을 기준으로 토큰 분리
+static inline vector<string> split(const string &s) {
+    vector<string> out;
+    istringstream iss(s);
+    string tok;
+    while (iss >> tok) out.push_back(tok);
+    return out;
+}
+// 16진수 문자 하나 -> 값 (16진수 문자가 아니면 -1)
+static inline int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+// 16진수 형식 문자열 -> 16진수 (stringstream 없이 직접 변환)
+static inline size_t hexstrToHex(const string &hexStr, size_t pos = 0, size_t len = string::npos) {
+    size_t v = 0;
+    size_t end = (len == string::npos || pos + len > hexStr.size()) ? hexStr.size() : pos + len;
+    for (size_t i = pos; i < end; i++) {
+        int d = hexDigit(hexStr[i]);
+        if (d < 0) break;
+        v = (v << 4) | (size_t)d;
+    }
+    return v;
+}
+// 16진수 주소 width개의 패딩(0) 갖는 문자열로 변환
+static inline string hexPad(size_t v, int width) {
+    stringstream ss;
+    ss << uppercase << hex << setw(width) << setfill('0') << v;
+    return ss.str();
+}
+
+/**
+ * Memory 클래스
+ */
+class Memory {
+private:
+    char mem[32758] = { 0 };
+    string programName; // 프로그램 이름
+    size_t programStart = 0; // 프로그램 논리적 시작 주소
+    size_t loadAddress = 0; // 프로그램이 실제로 로드되는 주소
+    size_t programLength = 0; // 프로그램 길이
+
+public:
+    /** 메모리 read/write */
+    void writeByte(size_t address, unsigned char value) { mem[address] = value; }
+    unsigned char readByte(size_t address) const { return mem[address]; }
+
+    /** 메모리 관련 */
+    char* getMemPtr() { return mem; }
+    size_t getMemSize() const { return sizeof(mem); }
+
+    /** getter / setter */
+    void setProgramName(const string &name) { programName = name; }
+    string getProgramName() const { return programName; }
+
+    void setProgramStart(size_t val) { programStart = val; }
+    size_t getProgramStart() const { return programStart; }
+
+    void setLoadAddress(size_t val) { loadAddress = val; }
+    size_t getLoadAddress() const { return loadAddress; }
+
+    void setProgramLength(size_t val) { programLength = val; }
+    size_t getProgramLength() const { return programLength; }
+};
+
+/**
+ * 외부 심볼 테이블(ESTAB) 엔트리
+ * @param name 제어 섹션 이름 또는 외부 정의 심볼 이름
+ * @param addr 재배치가 반영된 절대 주소
+ * @param length 제어 섹션 길이 (심볼이면 0)
+ * @param isSection 제어 섹션 이름 여부
+ * @param section 소속 제어 섹션 이름
+ */
+struct EstabEntry { string name; size_t addr; size_t length; bool isSection; string section; };
+unordered_map<string, EstabEntry> ESTAB;
+
+/**
+ * pass1에서 읽어 둔 제어 섹션 하나
+ * 파일은 pass1에서 한 번만 읽고, T/M/E 레코드는 여기에 보관했다가 pass2에서 적용한다.
+ * @param name 제어 섹션 이름
+ * @param file 섹션이 들어 있던 obj 파일
+ * @param csaddr 섹션이 로드되는 주소 (CSADDR)
+ * @param start H 레코드의 시작 주소 (START). 레코드의 주소는 이 값을 기준으로 한다.
+ * @param length 섹션 길이
+ * @param symbols D 레코드에 정의된 심볼 이름 (레코드 순서)
+ * @param records H/D 이외의 레코드들 (T, M, R, E)
+ */
+struct ControlSection { string name; string file; size_t csaddr; size_t start; size_t length; vector<string> symbols; vector<string> records; };
+vector<ControlSection> SECTIONS;
+
+size_t EXECADDR = 0; // 실행 시작 주소
+bool execAddrSet = false;
+
+vector<string> ERRORS;
+void logError(const string &where, const string &msg) { ERRORS.push_back(where + ": " + msg); }
+
+// 섹션 안의 주소(START 기준)를 로드된 절대 주소로 변환
+static inline size_t relocate(const ControlSection &cs, size_t addr) { return cs.csaddr + addr - cs.start; }
+
+// 레코드에서 심볼 이름(6자리 고정 폭) 추출
+static inline string symbolAt(const string &record, size_t pos) {
+    if (pos >= record.size()) return "";
+    return trim(record.substr(pos, 6));
+}
+
+/**
+ * PASS1
+ * 1. obj 파일들을 순서대로 한 번씩만 읽는다.
+ * 2. H 레코드마다 새 제어 섹션을 CSADDR에 배치하고 ESTAB에 등록
+ * 3. D 레코드의 심볼을 CSADDR + (주소 - START)로 ESTAB에 등록
+ * 4. 나머지 레코드는 섹션에 보관, E 레코드에서 CSADDR += 섹션 길이
+ * @param files obj 파일 이름 목록
+ * @param progAddr 첫 제어 섹션이 로드될 주소 (PROGADDR)
+ */
+void linkPass1(const vector<string> &files, size_t progAddr) {
+    size_t csaddr = progAddr;
+
+    for (auto &fname : files) {
+        ifstream file(fname);
+        if (!file.is_open()) {
+            logError(fname, "cannot find object file");
+            continue;
+        }
+
+        ControlSection *cur = nullptr;
+        string record;
+        while (getline(file, record)) {
+            if (!record.empty() && record.back() == '\r') record.pop_back();
+            if (record.empty()) continue;
+
+            switch (record.front()) {
+            case 'H': {
+                // H + 이름(6) + 시작 주소(6) + 길이(6)
+                string name = symbolAt(record, 1);
+                size_t start = hexstrToHex(record, 7, 6);
+                size_t length = hexstrToHex(record, 13, 6);
+                if (ESTAB.count(name)) logError(fname, "duplicate control section " + name);
+                else ESTAB[name] = EstabEntry{name, csaddr, length, true, name};
+                SECTIONS.push_back(ControlSection{name, fname, csaddr, start, length, {}, {}});
+                cur = &SECTIONS.back();
+                break;
+            }
+            case 'D': {
+                // D + (이름(6) + 주소(6)) 반복
+                if (!cur) { logError(fname, "D record before H record"); break; }
+                for (size_t pos = 1; pos + 12 <= record.size(); pos += 12) {
+                    string name = symbolAt(record, pos);
+                    size_t addr = hexstrToHex(record, pos + 6, 6);
+                    if (name.empty()) continue;
+                    if (ESTAB.count(name)) logError(fname, "duplicate external symbol " + name);
+                    else {
+                        ESTAB[name] = EstabEntry{name, relocate(*cur, addr), 0, false, cur->name};
+                        cur->symbols.push_back(name);
+                    }
+                }
+                break;
+            }
+            case 'E':
+                if (!cur) { logError(fname, "E record before H record"); break; }
+                cur->records.push_back(record);
+                csaddr += cur->length; // 다음 제어 섹션은 바로 뒤에 배치
+                cur = nullptr;
+                break;
+            default:
+                if (!cur) { logError(fname, "record before H record"); break; }
+                cur->records.push_back(record);
+                break;
+            }
+        }
+        if (cur) { // E 레코드 없이 파일이 끝난 경우
+            logError(fname, "missing E record in " + cur->name);
+            csaddr += cur->length;
+        }
+    }
+}
+
+/**
+ * T 레코드 적재
+ * T + 시작 주소(6) + 길이(2) + object code
+ */
+void loadText(const string &record, const ControlSection &cs, Memory &memory) {
+    size_t address = relocate(cs, hexstrToHex(record, 1, 6));
+    size_t len = hexstrToHex(record, 7, 2);
+    if (address + len > memory.getMemSize()) {
+        logError(cs.name, "T record out of range at " + hexPad(address, 6));
+        return;
+    }
+    for (size_t i = 0, pos = 9; i < len && pos + 2 <= record.size(); i++, pos += 2) {
+        memory.writeByte(address + i, (unsigned char)((hexDigit(record[pos]) << 4) | hexDigit(record[pos + 1])));
+    }
+}
+
+/**
+ * M 레코드 적용
+ * M + 주소(6) + 하프 바이트 수(2) + [+|-]심볼
+ * 심볼이 없는 M 레코드(단일 프로그램 형식)는 재배치 거리(CSADDR - START)를 더한다.
+ */
+void applyModification(const string &record, const ControlSection &cs, Memory &memory) {
+    size_t address = relocate(cs, hexstrToHex(record, 1, 6));
+    size_t nibbles = hexstrToHex(record, 7, 2);
+    size_t count = (nibbles + 1) / 2; // 수정할 바이트 수
+    if (nibbles == 0 || nibbles > 8 || address + count > memory.getMemSize()) {
+        logError(cs.name, "invalid M record " + record);
+        return;
+    }
+
+    char sign = '+';
+    size_t value = cs.csaddr - cs.start; // 부호 없는 연산이므로 START > CSADDR이어도 필드 덧셈 결과는 같다
+    if (record.size() > 9) {
+        sign = record[9];
+        string sym = symbolAt(record, 10);
+        auto it = ESTAB.find(sym);
+        if (it == ESTAB.end()) {
+            logError(cs.name, "undefined external symbol " + sym);
+            return;
+        }
+        value = it->second.addr;
+    }
+
+    // 대상 바이트를 정수로 읽고, 하위 nibbles개 하프 바이트만 수정
+    uint64_t target = 0;
+    for (size_t i = 0; i < count; i++) target = (target << 8) | memory.readByte(address + i);
+    uint64_t mask = (nibbles >= 16) ? ~0ULL : ((1ULL << (4 * nibbles)) - 1);
+    uint64_t field = target & mask;
+    field = (sign == '-') ? field - value : field + value;
+    target = (target & ~mask) | (field & mask);
+
+    for (size_t i = 0; i < count; i++) {
+        memory.writeByte(address + i, (target >> 8 * (count - i - 1)) & 0xFF);
+    }
+}
+
+/**
+ * PASS2
+ * 보관해 둔 레코드를 섹션 순서대로 적용 (파일을 다시 읽지 않음)
+ * T -> 메모리 적재, M -> ESTAB 조회 후 수정, R -> 참조 심볼 존재 확인, E -> 실행 주소 결정
+ */
+void linkPass2(Memory &memory) {
+    for (auto &cs : SECTIONS) {
+        for (auto &record : cs.records) {
+            switch (record.front()) {
+            case 'T':
+                loadText(record, cs, memory);
+                break;
+            case 'M':
+                applyModification(record, cs, memory);
+                break;
+            case 'R':
+                for (size_t pos = 1; pos < record.size(); pos += 6) {
+                    string sym = symbolAt(record, pos);
+                    if (!sym.empty() && ESTAB.find(sym) == ESTAB.end()) logError(cs.name, "unresolved reference " + sym);
+                }
+                break;
+            case 'E':
+                // 첫 번째로 주소를 가진 E 레코드가 실행 시작 주소
+                if (!execAddrSet && record.size() >= 7) {
+                    EXECADDR = relocate(cs, hexstrToHex(record, 1, 6));
+                    execAddrSet = true;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * 두 패스를 실행하고 Memory의 프로그램 정보를 채운다.
+ */
+void linkAndLoad(const vector<string> &files, size_t progAddr, Memory &memory) {
+    ESTAB.clear(); SECTIONS.clear(); ERRORS.clear();
+    EXECADDR = progAddr; execAddrSet = false;
+    ESTAB.reserve(files.size() * 16);
+
+    linkPass1(files, progAddr);
+
+    size_t end = progAddr;
+    for (auto &cs : SECTIONS) end = cs.csaddr + cs.length;
+    if (end > memory.getMemSize()) {
+        cout << "out of range" << endl;
+        return;
+    }
+
+    linkPass2(memory);
+
+    memory.setProgramName(SECTIONS.empty() ? "" : SECTIONS.front().name);
+    memory.setProgramStart(EXECADDR);
+    memory.setLoadAddress(progAddr);
+    memory.setProgramLength(end - progAddr);
+}
+
+/**
+ * 로드 맵 출력 (제어 섹션과 그 심볼들)
+ */
+void printLoadMap() {
+    cout << left << setw(8) << "SECTION" << setw(8) << "SYMBOL" << setw(8) << "ADDRESS" << "LENGTH" << "\n";
+    for (auto &cs : SECTIONS) {
+        cout << left << setw(8) << cs.name << setw(8) << "" << setw(8) << hexPad(cs.csaddr, 6) << hexPad(cs.length, 6) << "\n";
+        for (auto &sym : cs.symbols) {
+            cout << left << setw(8) << "" << setw(8) << sym << hexPad(ESTAB[sym].addr, 6) << "\n";
+        }
+    }
+    cout << right;
+}
+
+/**
+ * 적재된 범위의 메모리 출력
+ */
+void printMemory(Memory &memory) {
+    ofstream memoryf("Memory State.txt");
+    size_t from = memory.getLoadAddress() & ~(size_t)0xF;
+    size_t to = memory.getLoadAddress() + memory.getProgramLength();
+    for (size_t i = from; i < to; i++) {
+        if (i % 16 == 0) {
+            memoryf << "\n" << hexPad(i, 6) << ":";
+            cout << "\n" << hexPad(i, 6) << ":";
+        }
+        memoryf << hexPad((unsigned char)memory.readByte(i), 2) << " ";
+        cout << hexPad((unsigned char)memory.readByte(i), 2) << " ";
+    }
+    cout << endl;
+}
+
+/**
+ * 사용법: linkingLoader PROGADDR obj1 [obj2 ...]
+ * 인자가 없으면 표준 입력으로 obj 파일 목록과 시작 주소를 받는다.
+ * 예: linkingLoader 4000 start3.obj
+ *     (START 3인 PROGA 뒤에 PROGB가 붙어야 함: LISTA=00400A, PROGB=00400D, 실행 주소 004000)
+ */
+int main(int argc, char **argv) {
+    Memory memory;
+    vector<string> files;
+    string inputStart;
+
+    if (argc >= 3) {
+        inputStart = argv[1];
+        for (int i = 2; i < argc; i++) files.push_back(argv[i]);
+    } else {
+        string line;
+        cout << "objfile 이름 입력 (공백으로 구분): ";
+        getline(cin, line);
+        files = split(line);
+
+        cout << "프로그램 시작 주소 입력: ";
+        cin >> inputStart;
+    }
+
+    linkAndLoad(files, hexstrToHex(inputStart), memory);
+
+    printLoadMap();
+    cout << "Execution address: " << hexPad(EXECADDR, 6) << "\n";
+    if (!ERRORS.empty()) {
+        cout << "Errors/Warnings:\n";
+        for (auto &e : ERRORS) cout << e << "\n";
+    }
+
+    printMemory(memory);
+    return ERRORS.empty() ? 0 : 1;
+}
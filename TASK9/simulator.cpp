@@ -0,0 +1,2510 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <cerrno>
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+using namespace std;
+
+// 문자열 앞뒤 공백 제거
+static inline string trim(const string &s) {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == string::npos) return "";
+    size_t b = s.find_last_not_of(" \t\r\n");
+    return s.substr(a, b - a + 1);
+}
+// 공백을 기준으로 토큰 분리
+static inline vector<string> split(const string &s) {
+    vector<string> out;
+    istringstream iss(s);
+    string tok;
+    while (iss >> tok) out.push_back(tok);
+    return out;
+}
+// 문자열 대문자로 변환
+static inline string toUpper(const string &s) {
+    string r = s;
+    for (auto &c : r) c = toupper((unsigned char)c);
+    return r;
+}
+// 16진수 형식 문자열 -> 16진수
+static inline size_t hexstrToHex(string hexStr) {
+    stringstream ss;
+    size_t hexOutput = 0;
+    ss << hex << hexStr;
+    ss >> hexOutput;
+
+    return hexOutput;
+}
+// 16진수 의미하는 decimal -> 16진수 형식 문자열 ex. 4369 -> "F"
+static inline string hexToHexstr(size_t hexInput) {
+    stringstream ss;
+
+    ss << uppercase << hex << hexInput;
+    string hexStr = ss.str();
+
+    return hexStr;
+}
+// 16진수 주소 width개의 패딩(0) 갖는 문자열로 변환
+static inline string hexPad(uint64_t v, int width) {
+    stringstream ss;
+    ss << uppercase << hex << setw(width) << setfill('0') << v;
+    return ss.str();
+}
+// 16진수 문자 -> 2진수 문자열 ex. 'F' -> "1111"
+string hexstrToBin(char hexChar) {
+    unsigned int value = stoi(string(1, hexChar), nullptr, 16);
+    return bitset<4>(value).to_string();
+}
+
+/**
+ * Memory 클래스
+ * 로더(task9-2)의 Memory와 같고, E 레코드의 실행 시작 주소를 추가로 가진다.
+ */
+class Memory {
+private:
+    char mem[32758] = { 0 };
+    string programName; // 프로그램 이름
+    size_t programStart = 0; // 프로그램 논리적 시작 주소
+    size_t loadAddress = 0; // 프로그램이 실제로 로드되는 주소
+    size_t programLength = 0; // 프로그램 길이
+    size_t entryAddress = 0; // 실행 시작 주소 (E 레코드, 재배치 반영)
+
+public:
+    /** 메모리 read/write */
+    void writeByte(size_t address, unsigned char value) { mem[address] = value; }
+    unsigned char readByte(size_t address) const { return mem[address]; }
+
+    /** 메모리 관련 */
+    char* getMemPtr() { return mem; }
+    size_t getMemSize() const { return sizeof(mem); }
+
+    /** getter / setter */
+    void setProgramName(const string &name) { programName = name; }
+    string getProgramName() const { return programName; }
+
+    void setProgramStart(size_t val) { programStart = val; }
+    size_t getProgramStart() const { return programStart; }
+
+    void setLoadAddress(size_t val) { loadAddress = val; }
+    size_t getLoadAddress() const { return loadAddress; }
+
+    void setProgramLength(size_t val) { programLength = val; }
+    size_t getProgramLength() const { return programLength; }
+
+    void setEntryAddress(size_t val) { entryAddress = val; }
+    size_t getEntryAddress() const { return entryAddress; }
+};
+
+// ---------- loader ----------
+/**
+ * obj 파일을 Memory에 로드 (task9-2의 로더와 같은 방식)
+ * E 레코드에서 실행 시작 주소를 정한다.
+ */
+void HParse(string record, Memory &memory);
+void TParse(string record, Memory &memory);
+void MParse(string record, Memory &memory);
+void EParse(string record, Memory &memory);
+
+bool fileRead(string name, Memory &memory) {
+    ifstream file(name);
+    if (!file.is_open()) {
+        cout << "cannot find object file" << endl;
+        return false;
+    }
+
+    string record;
+    while (getline(file, record)) {
+        if (!record.empty() && record.back() == '\r') record.pop_back();
+        if (record.empty()) continue;
+        switch (record.front()) {
+        case 'H':
+            HParse(record, memory);
+            break;
+        case 'T':
+            TParse(record, memory);
+            break;
+        case 'M':
+            MParse(record, memory);
+            break;
+        case 'E':
+            EParse(record, memory);
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * H 레코드 읽기
+ */
+void HParse(string record, Memory &memory) {
+    memory.setProgramName(trim(record.substr(1, 6)));
+    memory.setProgramStart(hexstrToHex(record.substr(7, 6)));
+    memory.setProgramLength(hexstrToHex(record.substr(13, 6)));
+    memory.setEntryAddress(memory.getLoadAddress());
+
+    if (memory.getMemSize() - memory.getLoadAddress() < memory.getProgramLength()) {
+        cout << "out of range" << endl;
+        return;
+    }
+}
+
+/**
+ * T 레코드 읽기
+ */
+void TParse(string record, Memory &memory) {
+    size_t offset = memory.getLoadAddress() - memory.getProgramStart(); // 오프셋: 실제 로드되는 주소와 프로그램에 작성한 주소간 거리차
+    size_t address = hexstrToHex(record.substr(1,6)) + offset; // 메모리에 로드되는 주소
+    size_t len = hexstrToHex(record.substr(7, 2));  // 길이
+    string objcode = record.substr(9); // object code 부분
+
+    for (size_t i = 0; i < len && 2 * i + 2 <= objcode.length(); i++) {
+        if (address + i >= memory.getMemSize()) {
+            cout << "out of range" << endl;
+            return;
+        }
+        memory.writeByte(address + i, (unsigned char)hexstrToHex(objcode.substr(2 * i, 2)));
+    }
+}
+
+/**
+ * M 레코드 읽기
+ * 하위 nibbles개 하프 바이트에 오프셋을 더한다.
+ */
+void MParse(string record, Memory &memory) {
+    size_t offset = memory.getLoadAddress() - memory.getProgramStart();
+    size_t address = hexstrToHex(record.substr(1,6)) + offset;
+    size_t nibbles = hexstrToHex(record.substr(7, 2));
+    size_t count = (nibbles + 1) / 2;
+    if (nibbles == 0 || address + count > memory.getMemSize()) return;
+
+    uint32_t target = 0;
+    for (size_t i = 0; i < count; i++) target = (target << 8) | memory.readByte(address + i);
+    uint32_t mask = (uint32_t)((1ULL << (4 * nibbles)) - 1);
+    target = (target & ~mask) | ((target + (uint32_t)offset) & mask);
+    for (size_t i = 0; i < count; i++) {
+        memory.writeByte(address + i, (target >> 8*(count-i-1)) & 0xFF);
+    }
+}
+
+/**
+ * E 레코드 읽기
+ * 실행 시작 주소 = E 레코드 주소 + 오프셋 (주소가 없으면 로드 주소)
+ */
+void EParse(string record, Memory &memory) {
+    size_t offset = memory.getLoadAddress() - memory.getProgramStart();
+    if (record.size() >= 7) memory.setEntryAddress(hexstrToHex(record.substr(1, 6)) + offset);
+}
+
+// ---------- OPTAB ----------
+// optab.txt에서 읽은 명령어 이름 -> opcode
+unordered_map<string, uint8_t> OPTAB;
+bool loadOptab(const string &fname) {
+    ifstream ifs(fname); if (!ifs) return false;
+    string line;
+    while (getline(ifs, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '.') continue;
+        auto toks = split(line);
+        if (toks.size() < 2) continue;
+        OPTAB[toUpper(toks[0])] = (uint8_t)hexstrToHex(toks[1]);
+    }
+    return !OPTAB.empty();
+}
+
+// ---------- CPU formats & registers ----------
+// 레지스터 이름-번호 (어셈블러와 같은 번호)
+unordered_map<string,int> REGNUM = {{"A",0},{"X",1},{"L",2},{"B",3},{"S",4},{"T",5},{"F",6},{"PC",8},{"SW",9}};
+enum Reg { R_A = 0, R_X = 1, R_L = 2, R_B = 3, R_S = 4, R_T = 5, R_F = 6, R_PC = 8, R_SW = 9 };
+// Format 1, 2에 해당하는 명령어 집합
+unordered_set<string> FORMAT1 = {"FIX","FLOAT","NORM","SIO","HIO","TIO"};
+unordered_set<string> FORMAT2 = {"ADDR","COMPR","CLEAR","TIXR","RMO","SVC","SHIFTL","SHIFTR","MULR","DIVR","SUBR","SSK"};
+
+/**
+ * 명령어 의미 목록 (X-macro)
+ * OP(이름, 본문): 본문은 디코딩된 명령어 in, 명령어 주소 pc, 레지스터 배열 r을 사용한다.
+ * 같은 목록으로 OpId, switch 실행, computed-goto 레이블을 모두 만들어 의미가 한 곳에만 있도록 한다.
+ * 첫 항목은 OP_INVALID(0)여야 한다.
+ */
+#define SIC_OPS(OP) \
+    OP(INVALID,  halt("invalid opcode " + hexPad(mem[pc], 2) + " at " + hexPad(pc, 6));) \
+    /* 산술/논리 */ \
+    OP(ADD,      r[R_A] = (r[R_A] + operandWord(in)) & WORD_MASK;) \
+    OP(SUB,      r[R_A] = (r[R_A] - operandWord(in)) & WORD_MASK;) \
+    OP(MUL,      r[R_A] = (uint32_t)((int64_t)sx24(r[R_A]) * sx24(operandWord(in))) & WORD_MASK;) \
+    OP(DIV,      { int32_t d = sx24(operandWord(in)); \
+                   if (d == 0) halt("division by zero at " + hexPad(pc, 6)); \
+                   else r[R_A] = (uint32_t)(sx24(r[R_A]) / d) & WORD_MASK; }) \
+    OP(AND,      r[R_A] &= operandWord(in);) \
+    OP(OR,       r[R_A] |= operandWord(in);) \
+    OP(COMP,     setCC(sx24(r[R_A]), sx24(operandWord(in)));) \
+    OP(TIX,      r[R_X] = (r[R_X] + 1) & WORD_MASK; setCC(sx24(r[R_X]), sx24(operandWord(in)));) \
+    /* 점프 */ \
+    OP(J,        jump(pc, effectiveAddress(in));) \
+    OP(JEQ,      if (getCC() == CC_EQ) jump(pc, effectiveAddress(in));) \
+    OP(JGT,      if (getCC() == CC_GT) jump(pc, effectiveAddress(in));) \
+    OP(JLT,      if (getCC() == CC_LT) jump(pc, effectiveAddress(in));) \
+    OP(JSUB,     r[R_L] = r[R_PC]; r[R_PC] = effectiveAddress(in);) \
+    OP(RSUB,     if (r[R_L] == HALT_ADDRESS) halt("RSUB to loader"); else r[R_PC] = r[R_L];) \
+    /* 로드/저장 */ \
+    OP(LDA,      r[R_A] = operandWord(in);) \
+    OP(LDB,      r[R_B] = operandWord(in);) \
+    OP(LDL,      r[R_L] = operandWord(in);) \
+    OP(LDS,      r[R_S] = operandWord(in);) \
+    OP(LDT,      r[R_T] = operandWord(in);) \
+    OP(LDX,      r[R_X] = operandWord(in);) \
+    OP(LDCH,     r[R_A] = (r[R_A] & 0xFFFF00) | operandByte(in);) \
+    OP(STA,      store(in, r[R_A]);) \
+    OP(STB,      store(in, r[R_B]);) \
+    OP(STL,      store(in, r[R_L]);) \
+    OP(STS,      store(in, r[R_S]);) \
+    OP(STT,      store(in, r[R_T]);) \
+    OP(STX,      store(in, r[R_X]);) \
+    OP(STSW,     store(in, r[R_SW]);) \
+    OP(STCH,     if (in.mode == AM_IMMEDIATE) halt("store with immediate operand at " + hexPad(pc, 6)); \
+                 else storeByte(effectiveAddress(in), r[R_A] & 0xFF);) \
+    /* 장치 입출력: 피연산자 바이트가 장치 번호 (DeviceTable) */ \
+    OP(TD,       setCC(0, 1);) /* '<' = 준비됨 (버퍼 장치는 항상 준비) */ \
+    OP(RD,       { uint8_t c; \
+                   if (!devices.readByte(operandByte(in), c)) halt(devices.error); \
+                   else r[R_A] = (r[R_A] & 0xFFFF00) | c; }) \
+    OP(WD,       if (!devices.writeByte(operandByte(in), r[R_A] & 0xFF)) halt(devices.error);) \
+    /* Format 2 (레지스터 번호 10 이상은 A로 취급하지 않고 무시) */ \
+    OP(ADDR,     if (in.r2 < 10) r[in.r2] = (r[in.r2] + r[in.r1]) & WORD_MASK;) \
+    OP(SUBR,     if (in.r2 < 10) r[in.r2] = (r[in.r2] - r[in.r1]) & WORD_MASK;) \
+    OP(MULR,     if (in.r2 < 10) r[in.r2] = (uint32_t)((int64_t)sx24(r[in.r2]) * sx24(r[in.r1])) & WORD_MASK;) \
+    OP(DIVR,     if (in.r2 >= 10 || sx24(r[in.r1]) == 0) halt("division by zero at " + hexPad(pc, 6)); \
+                 else r[in.r2] = (uint32_t)(sx24(r[in.r2]) / sx24(r[in.r1])) & WORD_MASK;) \
+    OP(COMPR,    setCC(sx24(r[in.r1]), sx24(r[in.r2 < 10 ? in.r2 : 0]));) \
+    OP(CLEAR,    r[in.r1] = 0;) \
+    OP(RMO,      if (in.r2 < 10) r[in.r2] = r[in.r1];) \
+    OP(TIXR,     r[R_X] = (r[R_X] + 1) & WORD_MASK; setCC(sx24(r[R_X]), sx24(r[in.r1]));) \
+    OP(SHIFTL,   { uint32_t n = (in.r2 + 1) % 24, v = r[in.r1]; /* 순환 왼쪽 시프트 (r2 + 1비트) */ \
+                   r[in.r1] = ((v << n) | (v >> (24 - n))) & WORD_MASK; }) \
+    OP(SHIFTR,   r[in.r1] = (uint32_t)(sx24(r[in.r1]) >> (in.r2 + 1)) & WORD_MASK;) /* 산술 오른쪽 시프트 */ \
+    OP(SVC,      halt("SVC " + to_string(in.r1));) \
+    /* 부동소수점 (F는 host double, 메모리는 48비트 형식) */ \
+    OP(ADDF,     floatArith(pc, in, OP_ADDF);) \
+    OP(SUBF,     floatArith(pc, in, OP_SUBF);) \
+    OP(MULF,     floatArith(pc, in, OP_MULF);) \
+    OP(DIVF,     floatArith(pc, in, OP_DIVF);) \
+    OP(COMPF,    floatArith(pc, in, OP_COMPF);) \
+    OP(LDF,      loadF(pc, in);) \
+    OP(STF,      storeF(pc, in);) \
+    OP(FIX,      { double t = trunc(fReg); /* 0 쪽으로 버린 값이 [-2^23, 2^23-1]이어야 함 (NaN도 overflow) */ \
+                   if (!(t >= -0x1p23 && t < 0x1p23)) halt("FIX overflow at " + hexPad(pc, 6)); \
+                   else r[R_A] = (uint32_t)(int32_t)t & WORD_MASK; }) \
+    OP(FLOAT,    fReg = (double)sx24(r[R_A]); fRawValid = false;) /* 24비트 정수는 정확히 표현됨 */ \
+    OP(NORM,     fRawValid = false;) /* LDF한 값은 정규화되지 않았을 수 있음. 원래 형식을 버리면 STF가 정규화해서 저장 (지수 범위보다 작아지면 0) */ \
+    /* optab에는 있지만 시뮬레이터가 지원하지 않는 명령어 (SIO, LPS 등) */ \
+    OP(UNSUPPORTED, unsupported(pc);) \
+    /* 중단점: optab에는 없고, 디코드 캐시 엔트리를 이 번호로 바꿔 건다 */ \
+    OP(BREAK,    debugTrap(pc);)
+
+/**
+ * 시뮬레이터 내부 명령어 번호
+ * optab.txt의 mnemonic과 이름으로 연결되어 opcode 값이 바뀌어도 따라간다.
+ */
+enum OpId : uint8_t {
+#define ENUM_OP(name, ...) OP_##name,
+    SIC_OPS(ENUM_OP)
+#undef ENUM_OP
+    OP_COUNT
+};
+
+// mnemonic -> OpId
+unordered_map<string, OpId> OPNAMES = {
+#define NAME_OP(name, ...) {#name, OP_##name},
+    SIC_OPS(NAME_OP)
+#undef NAME_OP
+};
+
+// OpId -> mnemonic (프로파일 출력용)
+const char *OPID_NAMES[OP_COUNT] = {
+#define STR_OP(name, ...) #name,
+    SIC_OPS(STR_OP)
+#undef STR_OP
+};
+
+/**
+ * 명령어별 예상 사이클 수 (프로파일러용 추정치)
+ * 메모리 참조 명령은 인출 + 피연산자 접근, Format 2는 인출만으로 보고
+ * 곱셈/나눗셈, 부동소수점, 장치 입출력은 더 크게 잡는다.
+ */
+static uint32_t opCycles(OpId id) {
+    switch (id) {
+    case OP_ADDR: case OP_SUBR: case OP_COMPR: case OP_CLEAR: case OP_RMO: case OP_TIXR:
+    case OP_SHIFTL: case OP_SHIFTR: return 1;
+    case OP_J: case OP_JEQ: case OP_JGT: case OP_JLT: case OP_RSUB: return 2;
+    case OP_JSUB: return 3;
+    case OP_MULR: return 5;
+    case OP_MUL: return 6;
+    case OP_DIVR: return 11;
+    case OP_DIV: return 12;
+    case OP_ADDF: case OP_SUBF: case OP_COMPF: case OP_LDF: case OP_STF:
+    case OP_FIX: case OP_FLOAT: case OP_NORM: return 8;
+    case OP_MULF: return 12;
+    case OP_DIVF: return 20;
+    case OP_TD: case OP_RD: case OP_WD: return 20;
+    default: return 3;
+    }
+}
+
+/**
+ * 첫 바이트로 찾는 디스패치 테이블 엔트리
+ * @param id 명령어 번호
+ * @param format 1, 2, 3(3/4 형식)
+ * @param mnemonic 이름 (출력용)
+ */
+struct OpInfo { OpId id; uint8_t format; const char *mnemonic; };
+OpInfo DISPATCH[256];
+vector<string> OPNAME_STORAGE; // DISPATCH의 mnemonic 문자열 보관
+
+/**
+ * OPTAB으로 256칸 디스패치 테이블 구성
+ * Format 3/4는 첫 바이트 하위 2비트가 n, i이므로 opcode..opcode+3 네 칸을 모두 채운다.
+ * Format 1/2는 opcode 칸 하나만 채운다.
+ */
+void buildDispatch() {
+    for (auto &d : DISPATCH) d = OpInfo{OP_INVALID, 0, "?"};
+    OPNAME_STORAGE.clear();
+    OPNAME_STORAGE.reserve(OPTAB.size());
+    for (auto &p : OPTAB) {
+        OPNAME_STORAGE.push_back(p.first);
+        const char *name = OPNAME_STORAGE.back().c_str();
+        auto it = OPNAMES.find(p.first);
+        OpId id = (it == OPNAMES.end() || it->second == OP_INVALID) ? OP_UNSUPPORTED : it->second;
+        uint8_t op = p.second & 0xFC;
+        if (FORMAT1.count(p.first)) DISPATCH[op] = OpInfo{id, 1, name};
+        else if (FORMAT2.count(p.first)) DISPATCH[op] = OpInfo{id, 2, name};
+        else for (int ni = 0; ni < 4; ni++) DISPATCH[op | ni] = OpInfo{id, 3, name};
+    }
+}
+
+// ---------- CPU ----------
+// 24비트 워드
+static const uint32_t WORD_MASK = 0xFFFFFF;
+// 24비트 부호 확장
+static inline int32_t sx24(uint32_t v) { return (int32_t)(v << 8) >> 8; }
+
+// 주소 지정 방식 (n, i 비트)
+enum AddrMode : uint8_t { AM_SIC = 0, AM_IMMEDIATE = 1, AM_INDIRECT = 2, AM_SIMPLE = 3 };
+// 디코딩 플래그
+enum DecodeFlag : uint8_t { DF_X = 1, DF_B = 2 };
+
+/**
+ * 디코딩된 명령어
+ * buildFormat34의 역순으로 nixbpe를 풀어 둔다.
+ * PC-relative는 명령어 주소를 알고 있으므로 disp에 절대 주소로 미리 계산해 둔다.
+ * @param handler threaded 실행에서 점프할 레이블 (디코드 캐시에 저장)
+ * @param id 명령어 번호
+ * @param length 명령어 길이 (1~4). 디코드 캐시에서 0이면 빈 칸
+ * @param mode 주소 지정 방식 (n, i)
+ * @param flags DF_X(인덱스), DF_B(베이스 상대)
+ * @param r1, r2 Format 2 레지스터
+ * @param disp 주소 계산의 기준값 (절대 주소 또는 B 기준 변위)
+ */
+struct Instr {
+    const void *handler;
+    OpId id;
+    uint8_t length;
+    uint8_t mode;
+    uint8_t flags;
+    uint8_t r1, r2;
+    uint32_t disp;
+};
+
+/**
+ * 디코딩된 명령어 캐시
+ * 주소를 인덱스로 하는 평면 배열. length가 0인 칸은 아직 디코딩되지 않았거나 무효화된 칸이다.
+ * 디코딩된 명령어가 걸쳐 있는 256바이트 페이지를 표시해 두고,
+ * 저장 명령이 그 페이지를 건드릴 때만 해당 범위의 칸을 무효화한다.
+ * 페이지 표시에는 감시점 비트도 함께 두어 저장 경로의 검사 하나로 둘 다 걸러낸다.
+ */
+class DecodeCache {
+public:
+    static const int PAGE_SHIFT = 8;
+    enum PageBit : uint8_t { PAGE_CODE = 1, PAGE_WWATCH = 2, PAGE_RWATCH = 4 };
+
+    Instr *entries = nullptr; // 지금 쓰는 칸 (own 또는 다른 캐시의 칸)
+    size_t count = 0;
+    vector<Instr> own;
+    bool shared = false;      // 다른 캐시의 칸을 읽기 전용으로 빌려 쓰는 중
+    vector<uint8_t> codePage;
+    uint64_t fills = 0; // 디코딩해서 채운 횟수
+    uint64_t invalidations = 0; // 무효화된 칸 수
+
+    void init(size_t memSize) {
+        own.assign(memSize, Instr{nullptr, OP_INVALID, 0, 0, 0, 0, 0, 0});
+        entries = own.data();
+        count = memSize;
+        shared = false;
+        codePage.assign((memSize >> PAGE_SHIFT) + 1, 0);
+        fills = invalidations = 0;
+    }
+    /**
+     * 미리 채워 둔 캐시를 복사 없이 빌려 쓴다 (같은 이미지를 실행하는 여러 인스턴스용)
+     * 칸을 고쳐야 할 때(빈 칸 채우기, 무효화)만 privatize로 자기 사본을 만든다.
+     */
+    void share(const DecodeCache &src) {
+        own.clear();
+        own.shrink_to_fit();
+        entries = src.entries;
+        count = src.count;
+        shared = true;
+        codePage = src.codePage;
+        fills = invalidations = 0;
+    }
+    void privatize() {
+        if (!shared) return;
+        own.assign(entries, entries + count);
+        entries = own.data();
+        shared = false;
+    }
+    // handler가 없는 칸 비우기 (threaded 실행 전)
+    void dropUnlabeled() {
+        for (size_t a = 0; a < count; a++) {
+            if (!entries[a].length || entries[a].handler) continue;
+            privatize();
+            entries[a].length = 0;
+        }
+    }
+    void markCode(uint32_t addr, uint32_t len) {
+        for (uint32_t p = addr >> PAGE_SHIFT; p <= (addr + len - 1) >> PAGE_SHIFT && p < codePage.size(); p++) codePage[p] |= PAGE_CODE;
+    }
+    inline bool touchesCode(uint32_t addr, uint32_t len) const {
+        return (pageBits(addr, len) & PAGE_CODE) != 0;
+    }
+    inline uint8_t pageBits(uint32_t addr, uint32_t len) const {
+        return codePage[addr >> PAGE_SHIFT] | codePage[(addr + len - 1) >> PAGE_SHIFT];
+    }
+    // [addr, addr+len)에 걸치는 명령어 무효화 (최대 4바이트 앞에서 시작한 명령어까지)
+    void invalidate(uint32_t addr, uint32_t len) {
+        uint32_t from = addr >= 3 ? addr - 3 : 0;
+        for (uint32_t a = from; a < addr + len && a < count; a++) {
+            Instr &e = entries[a];
+            if (e.length && a + e.length > addr) {
+                if (shared) { privatize(); invalidate(addr, len); return; }
+                e.length = 0; e.handler = nullptr; ++invalidations;
+            }
+        }
+    }
+};
+
+// 조건 코드 (SW의 CC 비트 6-7)
+enum CondCode : uint32_t { CC_LT = 0, CC_EQ = 1, CC_GT = 2 };
+
+// ---------- 48비트 부동소수점 ----------
+// 부호 1비트, 지수 11비트 (excess-1024), 소수 36비트. 값 = f * 2^(e-1024), 정규화되면 0.5 <= f < 1
+static const int FLOAT_FRAC_BITS = 36;
+static const uint64_t FLOAT_FRAC_MASK = (1ULL << FLOAT_FRAC_BITS) - 1;
+
+/**
+ * 48비트 메모리 형식 -> double
+ * 36비트 소수는 double 가수(53비트)에 그대로 들어가므로 항상 정확하다. (정규화되지 않은 값도 값 그대로)
+ */
+static double sicFloatToDouble(uint64_t bits) {
+    uint64_t frac = bits & FLOAT_FRAC_MASK;
+    int exp = (int)((bits >> FLOAT_FRAC_BITS) & 0x7FF);
+    double v = ldexp((double)frac, exp - 1024 - FLOAT_FRAC_BITS);
+    return (bits >> 47) & 1 ? -v : v;
+}
+
+/**
+ * double -> 48비트 메모리 형식 (정규화해서 저장)
+ * v는 roundSicFloat를 거친 값이거나 LDF로 읽은 값이다. 정규화되지 않은 작은 값을 읽었다면
+ * 정규화한 지수가 범위보다 작을 수 있으므로 roundSicFloat처럼 0으로 만든다.
+ */
+static uint64_t doubleToSicFloat(double v) {
+    if (v == 0) return 0;
+    uint64_t sign = v < 0 ? 1 : 0;
+    int k;
+    double m = frexp(fabs(v), &k); // |v| = m * 2^k, 0.5 <= m < 1
+    if (k + 1024 < 0) return 0;
+    uint64_t frac = (uint64_t)ldexp(m, FLOAT_FRAC_BITS);
+    return (sign << 47) | ((uint64_t)(k + 1024) << FLOAT_FRAC_BITS) | frac;
+}
+
+/**
+ * 정확한 결과 x = p + err (p는 double로 반올림한 결과, err는 그 오차)를 36비트 소수로 반올림
+ * (가장 가까운 값, 같으면 짝수)
+ * 36비트 경계의 중간값은 double로 정확히 표현되므로 p와 x 사이에 다른 중간값이 있을 수 없고,
+ * p가 정확히 중간값일 때만 err의 부호로 방향을 정하면 한 번 반올림한 것과 같다.
+ * @param overflow 지수가 범위를 넘으면 true (범위보다 작으면 0으로 만든다)
+ */
+static double roundSicFloat(double p, double err, bool &overflow) {
+    overflow = !isfinite(p);
+    if (overflow || p == 0) return 0;
+    bool neg = p < 0;
+    if (neg) { p = -p; err = -err; }
+    int k;
+    double scaled = ldexp(frexp(p, &k), FLOAT_FRAC_BITS); // [2^35, 2^36)
+    double fl = floor(scaled), diff = scaled - fl;
+    bool up = diff > 0.5 || (diff == 0.5 && (err > 0 || (err == 0 && fmod(fl, 2.0) != 0)));
+    if (up) fl += 1;
+    if (fl == ldexp(1.0, FLOAT_FRAC_BITS)) { fl = ldexp(1.0, FLOAT_FRAC_BITS - 1); k++; }
+    if (k + 1024 > 2047) { overflow = true; return 0; }
+    if (k + 1024 < 0) return 0;
+    double r = ldexp(fl, k - FLOAT_FRAC_BITS);
+    return neg ? -r : r;
+}
+
+/**
+ * 장치 번호(00~FF) -> 호스트 파일/파이프
+ * 각 장치는 입력용 read-ahead 버퍼와 출력용 write-behind 버퍼를 따로 가지며,
+ * 파일은 처음 RD/WD가 일어날 때 연다. 연결하지 않은 장치는 표준 입력/출력을 쓴다.
+ * 버퍼가 있으므로 TD는 항상 준비됨으로 응답한다.
+ */
+class DeviceTable {
+public:
+    static const size_t BUF_SIZE = 1 << 16;
+
+    struct Device {
+        string path;              // 비어 있으면 표준 입력/출력, "-"도 같음
+        string outSuffix;         // 출력 파일 이름에 붙일 꼬리 (fork한 자식에서 사용)
+        int inFd = -1, outFd = -1;
+        vector<unsigned char> in; // read-ahead
+        size_t inPos = 0, inLen = 0;
+        bool eof = false;
+        vector<unsigned char> out; // write-behind
+        size_t outLen = 0;
+        uint64_t bytesRead = 0, bytesWritten = 0;
+        uint64_t fills = 0, flushes = 0; // 호스트 read/write 호출 수
+    };
+
+    Device dev[256];
+    string error; // 마지막 장치 오류
+    bool captureUnmapped = false; // 연결하지 않은 장치: 출력은 captured에 모으고 입력은 바로 끝
+    string captured;
+
+    ~DeviceTable() { closeAll(); }
+
+    // "F1=input.txt" 형식의 연결 지정
+    bool map(const string &spec) {
+        size_t eq = spec.find('=');
+        if (eq == string::npos || eq == 0 || eq > 2) return false;
+        dev[hexstrToHex(spec.substr(0, eq)) & 0xFF].path = spec.substr(eq + 1);
+        return true;
+    }
+
+    inline bool readByte(uint8_t d, uint8_t &v) {
+        Device &dv = dev[d];
+        if (dv.inPos == dv.inLen && !refill(d)) return false;
+        if (dv.eof) { v = 0; return true; } // 입력 끝: 0을 읽은 것으로 처리
+        v = dv.in[dv.inPos++];
+        ++dv.bytesRead;
+        return true;
+    }
+    inline bool writeByte(uint8_t d, uint8_t v) {
+        Device &dv = dev[d];
+        if (dv.outLen == dv.out.size() && !flush(d)) return false;
+        dv.out[dv.outLen++] = v;
+        ++dv.bytesWritten;
+        return true;
+    }
+
+    bool flush(uint8_t d) {
+        Device &dv = dev[d];
+        if (captureUnmapped && dv.path.empty()) {
+            if (dv.out.empty()) dv.out.resize(BUF_SIZE);
+            captured.append((const char *)dv.out.data(), dv.outLen);
+            if (dv.outLen) ++dv.flushes;
+            dv.outLen = 0;
+            return true;
+        }
+        if (dv.outFd < 0) {
+            if (dv.path.empty() || dv.path == "-") dv.outFd = STDOUT_FILENO;
+            else dv.outFd = open((dv.path + dv.outSuffix).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (dv.outFd < 0) { error = "cannot open device " + hexPad(d, 2) + " (" + dv.path + ")"; return false; }
+            dv.out.resize(BUF_SIZE);
+        }
+        if (dv.outFd == STDOUT_FILENO) { fflush(stdout); cout.flush(); } // stdio로 먼저 쓴 출력과 순서 맞춤
+        size_t done = 0;
+        while (done < dv.outLen) {
+            ssize_t n = write(dv.outFd, dv.out.data() + done, dv.outLen - done);
+            if (n < 0) { error = "write error on device " + hexPad(d, 2); return false; }
+            done += (size_t)n;
+        }
+        if (dv.outLen) ++dv.flushes;
+        dv.outLen = 0;
+        return true;
+    }
+    void flushAll() {
+        for (int d = 0; d < 256; d++) if (dev[d].outLen) flush((uint8_t)d);
+    }
+    void closeAll() {
+        flushAll();
+        for (auto &dv : dev) {
+            if (dv.inFd > STDIN_FILENO) close(dv.inFd);
+            if (dv.outFd > STDERR_FILENO) close(dv.outFd);
+            dv.inFd = dv.outFd = -1;
+        }
+    }
+
+    /**
+     * fork한 자식에서 호출: 파일 장치를 부모와 따로 쓰도록 다시 연다.
+     * 입력 파일은 부모가 읽은 위치(버퍼에 남은 양 제외)에서 이어 읽고,
+     * 출력 파일은 "경로.tag"로 바꿔 자식마다 따로 쓴다. (파이프와 표준 입출력은 공유)
+     * 부모는 fork 전에 flushAll로 출력 버퍼를 비워 두어야 한다.
+     */
+    void detach(int tag) {
+        for (int d = 0; d < 256; d++) {
+            Device &dv = dev[d];
+            if (dv.path.empty() || dv.path == "-") continue;
+            if (dv.inFd >= 0 && !dv.eof) {
+                off_t pos = lseek(dv.inFd, 0, SEEK_CUR);
+                close(dv.inFd);
+                dv.inFd = open(dv.path.c_str(), O_RDONLY);
+                if (dv.inFd >= 0 && pos >= 0) lseek(dv.inFd, pos - (off_t)(dv.inLen - dv.inPos), SEEK_SET);
+                dv.inPos = dv.inLen = 0;
+            }
+            if (dv.outFd >= 0) { close(dv.outFd); dv.outFd = -1; }
+            dv.outSuffix = "." + to_string(tag);
+        }
+    }
+    // 입력 장치를 다른 파일로 바꿈
+    void remapInput(uint8_t d, const string &path) {
+        Device &dv = dev[d];
+        if (dv.inFd > STDIN_FILENO) close(dv.inFd);
+        dv.inFd = -1;
+        dv.inPos = dv.inLen = 0;
+        dv.eof = false;
+        dv.path = path;
+    }
+
+private:
+    bool refill(uint8_t d) {
+        Device &dv = dev[d];
+        if (dv.eof) return true;
+        if (captureUnmapped && dv.path.empty()) { dv.eof = true; return true; }
+        if (dv.inFd < 0) {
+            if (dv.path.empty() || dv.path == "-") dv.inFd = STDIN_FILENO;
+            else dv.inFd = open(dv.path.c_str(), O_RDONLY);
+            if (dv.inFd < 0) { error = "cannot open device " + hexPad(d, 2) + " (" + dv.path + ")"; return false; }
+            dv.in.resize(BUF_SIZE);
+        }
+        ssize_t n = read(dv.inFd, dv.in.data(), BUF_SIZE);
+        if (n < 0) { error = "read error on device " + hexPad(d, 2); return false; }
+        ++dv.fills;
+        dv.inPos = 0;
+        dv.inLen = (size_t)n;
+        if (n == 0) dv.eof = true;
+        return true;
+    }
+};
+
+/**
+ * 실행 추적 한 칸 (16바이트)
+ * 실행 직전 상태를 기록하므로 레지스터 변화는 다음 칸과 비교해서 얻는다.
+ * @param pcOp 하위 24비트 PC, 상위 8비트 첫 바이트 (opcode | n i)
+ * @param ea Format 3/4는 목표 주소(TA), Format 2는 r1 << 4 | r2
+ * @param a 실행 전 A
+ * @param xcc 실행 전 X (하위 24비트), CC (상위 8비트)
+ */
+struct TraceEntry {
+    uint32_t pcOp;
+    uint32_t ea;
+    uint32_t a;
+    uint32_t xcc;
+};
+
+// 추적 파일 머리 (그 뒤에 링 버퍼 전체가 그대로 따라온다)
+struct TraceHeader {
+    char magic[8];     // "SICTRC1"
+    uint32_t entrySize;
+    uint32_t capacity;
+    uint64_t head;     // 지금까지 기록한 칸 수 (다음에 쓸 위치 = head % capacity)
+};
+
+/**
+ * 고정 크기 실행 추적 링 버퍼
+ * 기록하는 쪽은 CPU 하나뿐이고, 칸을 다 쓴 뒤 head를 release로 올리므로
+ * 시그널 핸들러가 잠금 없이 head까지의 칸을 그대로 파일에 쓸 수 있다.
+ * 실행 중에는 문자열로 바꾸지 않고, 해석은 -X로 따로 한다.
+ */
+class TraceRing {
+public:
+    static const size_t DEFAULT_ENTRIES = 1 << 16; // 1MB
+
+    vector<TraceEntry> ring;
+    size_t mask;
+    atomic<uint64_t> head{0};
+
+    explicit TraceRing(size_t entries = DEFAULT_ENTRIES) {
+        size_t n = 1;
+        while (n < entries) n <<= 1;
+        ring.assign(n, TraceEntry{0, 0, 0, 0});
+        mask = n - 1;
+    }
+
+    inline void record(uint32_t pc, uint8_t op, uint32_t ea, uint32_t a, uint32_t xcc) {
+        uint64_t h = head.load(memory_order_relaxed);
+        TraceEntry &t = ring[h & mask];
+        t.pcOp = (pc & 0xFFFFFF) | ((uint32_t)op << 24);
+        t.ea = ea;
+        t.a = a;
+        t.xcc = xcc;
+        head.store(h + 1, memory_order_release);
+    }
+
+    /**
+     * 파일로 저장 (open/write만 사용하므로 시그널 핸들러에서도 호출 가능)
+     */
+    bool dump(const char *path) const {
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        TraceHeader h;
+        memcpy(h.magic, "SICTRC1", 8);
+        h.entrySize = sizeof(TraceEntry);
+        h.capacity = (uint32_t)ring.size();
+        h.head = head.load(memory_order_acquire);
+        bool ok = write(fd, &h, sizeof(h)) == (ssize_t)sizeof(h);
+        size_t bytes = ring.size() * sizeof(TraceEntry);
+        ok = ok && write(fd, ring.data(), bytes) == (ssize_t)bytes;
+        close(fd);
+        return ok;
+    }
+};
+
+/**
+ * 중단점: addr에 도달했을 때 (조건이 있으면 조건이 참일 때) 실행 전에 멈춘다.
+ * @param reg 조건 레지스터 (-1이면 조건 없음)
+ * @param op '=', '!', '<', '>' (!는 !=)
+ */
+struct Breakpoint {
+    uint32_t addr = 0;
+    int reg = -1;
+    char op = 0;
+    uint32_t value = 0;
+    string spec;
+};
+// 감시점: [from, to] 범위를 읽거나(read) 쓰면(write) 멈춘다.
+struct Watchpoint {
+    uint32_t from = 0, to = 0;
+    bool read = false, write = true;
+    string spec;
+};
+
+struct Debugger {
+    vector<Breakpoint> breaks;
+    vector<Watchpoint> watches;
+    uint64_t breakChecks = 0; // 중단점 주소를 지난 횟수 (조건이 거짓이었던 경우 포함)
+
+    bool hasReadWatch() const {
+        for (auto &w : watches) if (w.read) return true;
+        return false;
+    }
+};
+
+/**
+ * 중단점 지정 읽기: "1009" 또는 "1009:X=64", "1009:A>10", "1009:T!=0" (16진수)
+ */
+bool parseBreakpoint(const string &spec, Breakpoint &b) {
+    b.spec = spec;
+    size_t colon = spec.find(':');
+    b.addr = (uint32_t)hexstrToHex(spec.substr(0, colon));
+    if (colon == string::npos) return true;
+    string cond = spec.substr(colon + 1);
+    size_t opPos = cond.find_first_of("=!<>");
+    if (opPos == string::npos || opPos == 0) return false;
+    string name = toUpper(cond.substr(0, opPos));
+    auto it = REGNUM.find(name);
+    if (it == REGNUM.end() || name == "F") return false;
+    b.reg = it->second;
+    b.op = cond[opPos];
+    size_t valPos = opPos + 1;
+    if (b.op == '!') { if (valPos >= cond.size() || cond[valPos] != '=') return false; valPos++; }
+    if (valPos >= cond.size()) return false;
+    b.value = (uint32_t)hexstrToHex(cond.substr(valPos)) & 0xFFFFFF;
+    return true;
+}
+
+/**
+ * 감시점 지정 읽기: "1030", "1030-1035", "1030:r", "1030-1035:rw" (기본 w)
+ */
+bool parseWatchpoint(const string &spec, Watchpoint &w) {
+    w.spec = spec;
+    size_t colon = spec.find(':');
+    string range = spec.substr(0, colon);
+    size_t dash = range.find('-');
+    w.from = (uint32_t)hexstrToHex(range.substr(0, dash));
+    w.to = dash == string::npos ? w.from : (uint32_t)hexstrToHex(range.substr(dash + 1));
+    if (w.to < w.from) return false;
+    if (colon != string::npos) {
+        string kind = toUpper(spec.substr(colon + 1));
+        w.read = kind.find('R') != string::npos;
+        w.write = kind.find('W') != string::npos;
+        if (!w.read && !w.write) return false;
+    }
+    return true;
+}
+
+// 실행 방식
+enum DispatchMode { DISPATCH_SWITCH, DISPATCH_CACHED, DISPATCH_THREADED, DISPATCH_BLOCK };
+
+class Cpu;
+
+// 실행 중 통계: SIGUSR1(또는 -P 주기의 SIGALRM) handler가 세우는 플래그
+// run이 STATS_SLICE 명령어마다 실행을 끊고 확인하므로 명령어마다 검사하는 비용은 없다
+static volatile sig_atomic_t STATS_REQUESTED = 0;
+static bool STATS_ENABLED = false;
+static const uint64_t STATS_SLICE = 1 << 22;
+void printLiveStats(Cpu &cpu);
+
+/**
+ * 번역된 명령어 하나 (함수 포인터 + 미리 계산한 피연산자)
+ * 자주 쓰는 주소 지정 형태(immediate, 절대 주소, 절대 주소 + X)는 전용 함수로,
+ * 나머지는 디코딩된 명령어를 그대로 execute에 넘기는 일반 함수로 번역한다.
+ * @param fn 실행 함수
+ * @param pc 명령어 주소
+ * @param nextPc 다음 명령어 주소
+ * @param value immediate 값, 절대 주소 또는 점프 목표
+ * @param r1, r2 레지스터 번호
+ * @param in 일반 함수용 디코딩 결과
+ */
+struct MicroOp {
+    void (*fn)(Cpu &, const MicroOp &);
+    uint32_t pc;
+    uint32_t nextPc;
+    uint32_t value;
+    uint8_t r1, r2;
+    Instr in;
+};
+
+/**
+ * 기본 블록 번역 결과
+ * 점프(J, JEQ, JLT, JGT, JSUB, RSUB)나 코드 영역에 쓰는 저장 명령에서 끝난다.
+ * succ에는 이 블록 다음에 실행된 블록을 기억해 두고 다음 번에는 표를 찾지 않고 바로 이어서 실행한다.
+ * @param start, end 블록 범위 [start, end)
+ * @param endsWithJump 마지막 명령어가 PC를 직접 정하는지 여부
+ * @param valid 코드가 바뀌어 무효화되면 false
+ */
+struct TransBlock {
+    uint32_t start = 0, end = 0;
+    vector<MicroOp> ops;
+    bool endsWithJump = false;
+    bool valid = true;
+    TransBlock *succ[2] = { nullptr, nullptr };
+};
+
+/**
+ * SIC/XE CPU
+ * 레지스터는 REGNUM 번호를 인덱스로 사용하고, 메모리는 로더의 Memory를 그대로 쓴다.
+ */
+class Cpu {
+public:
+    static const uint32_t HALT_ADDRESS = 0xFFFFFF; // 초기 L 값. RSUB로 여기 돌아오면 종료
+
+    uint32_t reg[10] = { 0 };
+    Memory &memory;
+    unsigned char *mem;
+    uint32_t memSize;
+    DecodeCache cache;
+    DeviceTable devices;
+    TraceRing *trace = nullptr; // 실행 추적 (nullptr이면 기록하지 않음)
+    Debugger *debug = nullptr;  // 중단점/감시점 (nullptr이면 없음)
+    vector<uint8_t> breakMark;  // 주소별 중단점 표시 (디코드 캐시를 채울 때만 확인)
+
+    // F 레지스터: 값은 double로 두고, LDF로 읽은 비트는 그대로 보관해 STF가 같은 비트를 쓰게 한다
+    double fReg = 0;
+    uint64_t fRaw = 0;
+    bool fRawValid = false;
+
+    bool halted = false;
+    string haltReason;
+    uint64_t steps = 0; // 실행한 명령어 수
+    chrono::steady_clock::time_point statsStart, statsLast; // 실행 중 통계: 시작 시각, 직전 출력 시각
+    uint64_t statsLastSteps = 0;
+    bool resumeSlice = false; // run이 나눈 구간을 이어서 실행하는 중 (threaded 캐시 정리 생략)
+
+    // 블록 번역 실행 상태
+    static const int BLOCK_MAX = 64;     // 블록 하나의 최대 명령어 수
+    static const uint8_t HOT_COUNT = 4;  // 이 횟수만큼 해석 실행된 블록 시작 주소를 번역
+    vector<unique_ptr<TransBlock>> blocks; // 번역한 블록 (무효화된 블록도 실행 중 참조될 수 있어 실행이 끝날 때까지 보관)
+    vector<TransBlock *> blockAt;          // 시작 주소 -> 유효한 블록
+    vector<vector<TransBlock *>> pageBlocks; // 코드 페이지 -> 그 페이지에 걸친 블록
+    vector<uint8_t> heat;                  // 블록 시작 주소별 해석 실행 횟수
+    bool stopBlock = false;                // 블록 실행 중 종료나 코드 변경이 일어남
+    uint64_t translatedSteps = 0;          // 번역된 블록에서 실행한 명령어 수
+    uint64_t interpretedSteps = 0;         // 블록 모드에서 해석 실행한 명령어 수
+    uint64_t blockInvalidations = 0;
+    uint64_t chainHits = 0;                // 직전 블록에서 바로 이어진 횟수
+
+    // 프로파일: 주소를 인덱스로 하는 실행 횟수/예상 사이클, 명령어별 실행 횟수
+    vector<uint64_t> profCount, profCycles;
+    uint64_t opCount[OP_COUNT] = { 0 };
+
+    /**
+     * @param sharedCache 같은 이미지로 미리 채운 디코드 캐시 (nullptr이면 자기 캐시)
+     */
+    explicit Cpu(Memory &m, const DecodeCache *sharedCache = nullptr)
+        : memory(m), mem((unsigned char *)m.getMemPtr()), memSize((uint32_t)m.getMemSize()) {
+        if (sharedCache) cache.share(*sharedCache);
+        else cache.init(memSize);
+    }
+
+    void reset(uint32_t entry) {
+        for (auto &r : reg) r = 0;
+        fReg = 0;
+        fRawValid = false;
+        reg[R_L] = HALT_ADDRESS;
+        reg[R_PC] = entry;
+        halted = false;
+        haltReason.clear();
+        steps = 0;
+        statsStart = statsLast = chrono::steady_clock::now();
+        statsLastSteps = 0;
+    }
+
+    void halt(const string &reason) {
+        halted = true;
+        haltReason = reason;
+        stopBlock = true;
+    }
+    void unsupported(uint32_t pc) {
+        halt(string("unsupported instruction ") + DISPATCH[mem[pc]].mnemonic + " at " + hexPad(pc, 6));
+    }
+
+    void setCC(int32_t a, int32_t b) {
+        uint32_t cc = a < b ? CC_LT : (a == b ? CC_EQ : CC_GT);
+        reg[R_SW] = (reg[R_SW] & ~0xC0u) | (cc << 6);
+    }
+    uint32_t getCC() const { return (reg[R_SW] >> 6) & 3; }
+
+    /** 메모리 접근 (범위를 벗어나면 종료, 코드 페이지에 쓰면 디코드 캐시 무효화) */
+    bool inRange(uint32_t addr, uint32_t len) {
+        if (addr + len <= memSize) return true;
+        halt("memory fault at " + hexPad(addr, 6));
+        return false;
+    }
+    uint32_t loadWord(uint32_t addr) {
+        if (!inRange(addr, 3)) return 0;
+        return ((uint32_t)mem[addr] << 16) | ((uint32_t)mem[addr + 1] << 8) | mem[addr + 2];
+    }
+    uint8_t loadByte(uint32_t addr) {
+        if (!inRange(addr, 1)) return 0;
+        return mem[addr];
+    }
+    void storeWord(uint32_t addr, uint32_t v) {
+        if (!inRange(addr, 3)) return;
+        mem[addr] = (v >> 16) & 0xFF;
+        mem[addr + 1] = (v >> 8) & 0xFF;
+        mem[addr + 2] = v & 0xFF;
+        if (cache.pageBits(addr, 3) & (DecodeCache::PAGE_CODE | DecodeCache::PAGE_WWATCH)) pageWritten(addr, 3);
+    }
+    void storeByte(uint32_t addr, uint8_t v) {
+        if (!inRange(addr, 1)) return;
+        mem[addr] = v;
+        if (cache.pageBits(addr, 1) & (DecodeCache::PAGE_CODE | DecodeCache::PAGE_WWATCH)) pageWritten(addr, 1);
+    }
+    /**
+     * 표시된 페이지(코드 또는 쓰기 감시)에 쓰기가 일어남
+     * 감시 범위면 멈추고, 디코드 캐시와 겹치는 번역 블록을 무효화한다.
+     * 실행 중인 블록은 현재 명령어까지만 실행하고 멈춘다.
+     */
+    void pageWritten(uint32_t addr, uint32_t len) {
+        if (debug && (cache.pageBits(addr, len) & DecodeCache::PAGE_WWATCH)) checkWatch(addr, len, true);
+        if (!cache.touchesCode(addr, len)) return; // 감시만 있는 페이지: 무효화할 코드가 없다
+        uint64_t before = cache.invalidations + blockInvalidations;
+        cache.invalidate(addr, len);
+        uint32_t first = addr >> DecodeCache::PAGE_SHIFT, last = (addr + len - 1) >> DecodeCache::PAGE_SHIFT;
+        for (uint32_t p = first; p <= last && p < pageBlocks.size(); p++) {
+            auto &list = pageBlocks[p];
+            for (size_t i = 0; i < list.size();) {
+                TransBlock *b = list[i];
+                if (b->valid && b->start < addr + len && addr < b->end) {
+                    b->valid = false;
+                    blockAt[b->start] = nullptr;
+                    heat[b->start] = 0;
+                    ++blockInvalidations;
+                }
+                if (!b->valid) { list[i] = list.back(); list.pop_back(); }
+                else i++;
+            }
+        }
+        if (cache.invalidations + blockInvalidations != before) stopBlock = true;
+    }
+
+    /**
+     * 부동소수점 피연산자 (6바이트) 주소. immediate는 허용하지 않는다.
+     * @return 범위를 벗어나거나 immediate면 false (종료됨)
+     */
+    bool floatAddress(uint32_t pc, const Instr &in, uint32_t &addr) {
+        if (in.mode == AM_IMMEDIATE) { halt("immediate float operand at " + hexPad(pc, 6)); return false; }
+        addr = effectiveAddress(in);
+        return !halted && inRange(addr, 6);
+    }
+    uint64_t loadFloatBits(uint32_t addr) const {
+        uint64_t v = 0;
+        for (int i = 0; i < 6; i++) v = (v << 8) | mem[addr + i];
+        return v;
+    }
+    void loadF(uint32_t pc, const Instr &in) {
+        uint32_t addr;
+        if (!floatAddress(pc, in, addr)) return;
+        fRaw = loadFloatBits(addr);
+        fRawValid = true;
+        fReg = sicFloatToDouble(fRaw);
+    }
+    void storeF(uint32_t pc, const Instr &in) {
+        uint32_t addr;
+        if (!floatAddress(pc, in, addr)) return;
+        uint64_t v = fRawValid ? fRaw : doubleToSicFloat(fReg);
+        storeWord(addr, (uint32_t)(v >> 24) & WORD_MASK);
+        storeWord(addr + 3, (uint32_t)v & WORD_MASK);
+    }
+    /**
+     * ADDF, SUBF, MULF, DIVF, COMPF
+     * double로 계산한 뒤 정확한 오차(TwoSum, fma)를 함께 넘겨 36비트로 한 번만 반올림한 결과를 만든다.
+     */
+    void floatArith(uint32_t pc, const Instr &in, OpId op) {
+        uint32_t addr;
+        if (!floatAddress(pc, in, addr)) return;
+        double a = fReg, b = sicFloatToDouble(loadFloatBits(addr)), p = 0, err = 0;
+        switch (op) {
+        case OP_COMPF: {
+            uint32_t cc = a < b ? CC_LT : (a == b ? CC_EQ : CC_GT);
+            reg[R_SW] = (reg[R_SW] & ~0xC0u) | (cc << 6);
+            return;
+        }
+        case OP_SUBF: b = -b; // fall through
+        case OP_ADDF: {
+            p = a + b;
+            double bv = p - a; // TwoSum
+            err = (a - (p - bv)) + (b - bv);
+            break;
+        }
+        case OP_MULF: p = a * b; err = fma(a, b, -p); break;
+        case OP_DIVF:
+            if (b == 0) { halt("division by zero at " + hexPad(pc, 6)); return; }
+            p = a / b;
+            err = fma(-p, b, a) / b; // 나머지 / b: 참값이 p보다 큰지 작은지
+            break;
+        default: return;
+        }
+        bool overflow;
+        double v = roundSicFloat(p, err, overflow);
+        if (overflow) { halt("floating-point overflow at " + hexPad(pc, 6)); return; }
+        fReg = v;
+        fRawValid = false;
+    }
+
+    /**
+     * pc 위치의 명령어 디코딩
+     * 디스패치 테이블로 형식을 정하고, Format 3/4는 nixbpe를 푼다.
+     */
+    bool decode(uint32_t pc, Instr &in) {
+        if (!inRange(pc, 1)) return false;
+        uint8_t b0 = mem[pc];
+        const OpInfo &info = DISPATCH[b0];
+        in.handler = nullptr; in.id = info.id; in.mode = 0; in.flags = 0; in.r1 = 0; in.r2 = 0; in.disp = 0;
+
+        if (info.id == OP_INVALID) { in.length = 1; return true; }
+        if (info.format == 1) { in.length = 1; return true; }
+        if (!inRange(pc, 2)) return false;
+        uint8_t b1 = mem[pc + 1];
+        if (info.format == 2) {
+            in.length = 2; in.r1 = b1 >> 4; in.r2 = b1 & 0xF;
+            if (in.r1 >= 10) in.id = OP_INVALID; // 존재하지 않는 레지스터
+            return true;
+        }
+        if (!inRange(pc, 3)) return false;
+        uint8_t b2 = mem[pc + 2];
+        in.mode = b0 & 3;
+        if (in.mode == AM_SIC) { // SIC 호환: x + 15비트 주소
+            in.length = 3;
+            if (b1 & 0x80) in.flags |= DF_X;
+            in.disp = ((uint32_t)(b1 & 0x7F) << 8) | b2;
+            return true;
+        }
+        if (b1 & 0x80) in.flags |= DF_X;
+        if (b1 & 0x10) { // e = 1: Format 4, 20비트 주소
+            if (!inRange(pc, 4)) return false;
+            in.length = 4;
+            in.disp = ((uint32_t)(b1 & 0x0F) << 16) | ((uint32_t)b2 << 8) | mem[pc + 3];
+            return true;
+        }
+        in.length = 3;
+        uint32_t disp12 = ((uint32_t)(b1 & 0x0F) << 8) | b2;
+        if (b1 & 0x20) { // p = 1: PC-relative, 부호 있는 12비트
+            int32_t sdisp = (disp12 & 0x800) ? (int32_t)disp12 - 0x1000 : (int32_t)disp12;
+            in.disp = (uint32_t)((int32_t)pc + 3 + sdisp) & 0xFFFFF;
+        } else if (b1 & 0x40) { // b = 1: Base-relative
+            in.flags |= DF_B;
+            in.disp = disp12;
+        } else {
+            in.disp = disp12;
+        }
+        return true;
+    }
+
+    /**
+     * 디코드 캐시에서 pc의 명령어를 찾고, 없으면 디코딩해서 채운다.
+     * @param handlers OpId -> 레이블 표 (threaded 실행이 아니면 nullptr)
+     */
+    inline const Instr *fetch(uint32_t pc, const void *const *handlers) {
+        if (pc >= memSize) { inRange(pc, 1); return nullptr; }
+        if (cache.entries[pc].length) return &cache.entries[pc];
+        cache.privatize();
+        Instr &e = cache.entries[pc];
+        if (!decode(pc, e)) { e.length = 0; return nullptr; }
+        if (!breakMark.empty() && breakMark[pc]) e.id = OP_BREAK; // 중단점: 채울 때만 바꿔 둔다
+        e.handler = handlers ? handlers[e.id] : nullptr;
+        cache.markCode(pc, e.length);
+        ++cache.fills;
+        return &e;
+    }
+
+    /**
+     * 디버거 연결
+     * 중단점 주소의 캐시 칸을 비워 두면 다음 fetch가 OP_BREAK로 채운다.
+     * 감시 범위의 페이지에는 감시 비트를 표시한다.
+     */
+    void attachDebugger(Debugger &d) {
+        debug = &d;
+        cache.privatize();
+        breakMark.assign(memSize, 0);
+        for (auto &b : d.breaks) {
+            if (b.addr >= memSize) continue;
+            breakMark[b.addr] = 1;
+            cache.entries[b.addr].length = 0;
+        }
+        for (auto &w : d.watches) {
+            uint8_t bits = (w.write ? DecodeCache::PAGE_WWATCH : 0) | (w.read ? DecodeCache::PAGE_RWATCH : 0);
+            for (uint32_t p = w.from >> DecodeCache::PAGE_SHIFT; p <= (w.to >> DecodeCache::PAGE_SHIFT) && p < cache.codePage.size(); p++)
+                cache.codePage[p] |= bits;
+        }
+    }
+
+    // OP_BREAK 칸을 만났을 때: 조건이 맞으면 실행 전에 멈추고, 아니면 원래 명령어를 실행
+    void debugTrap(uint32_t pc) {
+        Instr orig;
+        if (!decode(pc, orig)) return;
+        ++debug->breakChecks;
+        for (auto &b : debug->breaks) {
+            if (b.addr != pc) continue;
+            bool hit = true;
+            if (b.reg >= 0) {
+                int32_t v = sx24(reg[b.reg] & WORD_MASK), c = sx24(b.value);
+                hit = b.op == '=' ? v == c : b.op == '!' ? v != c : b.op == '<' ? v < c : v > c;
+            }
+            if (hit) {
+                reg[R_PC] = pc;
+                --steps; // 실행하지 않았으므로 디스패치에서 센 명령어를 되돌린다
+                halt("breakpoint " + b.spec);
+                return;
+            }
+        }
+        execute(pc, orig);
+    }
+
+    // [addr, addr+len)가 감시 범위와 겹치면 멈춤
+    bool checkWatch(uint32_t addr, uint32_t len, bool isWrite) {
+        for (auto &w : debug->watches) {
+            if (!(isWrite ? w.write : w.read) || addr > w.to || addr + len - 1 < w.from) continue;
+            string what = isWrite ? "write " : "read ";
+            what += hexPad(addr, 6);
+            if (isWrite) {
+                what += " = ";
+                for (uint32_t i = 0; i < len; i++) what += hexPad(mem[addr + i], 2);
+            }
+            halt("watchpoint " + w.spec + ": " + what);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * 명령어가 읽기 감시 범위를 읽는지 실행 전에 확인
+     * (간접 주소면 포인터 워드와 최종 피연산자 모두)
+     */
+    bool readsWatched(const Instr &in) {
+        if (in.length < 3 || in.mode == AM_IMMEDIATE) return false;
+        uint32_t ta = targetAddress(in);
+        if (in.mode == AM_INDIRECT) {
+            if ((cache.pageBits(ta, 3) & DecodeCache::PAGE_RWATCH) && checkWatch(ta, 3, false)) return true;
+            if (ta + 3 > memSize) return false;
+            ta = loadWord(ta) & 0xFFFFF;
+        }
+        uint32_t width;
+        switch (in.id) {
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_AND: case OP_OR: case OP_COMP: case OP_TIX:
+        case OP_LDA: case OP_LDB: case OP_LDL: case OP_LDS: case OP_LDT: case OP_LDX: width = 3; break;
+        case OP_LDCH: width = 1; break;
+        case OP_ADDF: case OP_SUBF: case OP_MULF: case OP_DIVF: case OP_COMPF: case OP_LDF: width = 6; break;
+        default: return false; // 저장, 점프 등은 피연산자를 읽지 않는다
+        }
+        if (ta + width > memSize) return false;
+        return (cache.pageBits(ta, width) & DecodeCache::PAGE_RWATCH) && checkWatch(ta, width, false);
+    }
+
+    /**
+     * 읽기 감시점이 있을 때만 쓰는 실행 (switch 디스패치 + 디코드 캐시 + 읽기 검사)
+     * 읽기 감시점이 없으면 다른 실행 방식은 이 검사를 전혀 하지 않는다.
+     */
+    void runWatched(uint64_t maxSteps) {
+        uint64_t limit = maxSteps ? maxSteps : UINT64_MAX;
+        while (!halted && steps < limit) {
+            uint32_t pc = reg[R_PC];
+            const Instr *e = fetch(pc, nullptr);
+            if (!e) break;
+            if (readsWatched(*e)) { reg[R_PC] = pc; break; }
+            ++steps;
+            if (trace) traceInstr(pc, *e);
+            execute(pc, *e);
+        }
+        if (!halted && steps >= limit) halt("step limit");
+    }
+
+    // 실행 직전 상태를 추적 버퍼에 기록
+    inline void traceInstr(uint32_t pc, const Instr &in) {
+        uint32_t ea = in.length >= 3 ? targetAddress(in) : ((uint32_t)in.r1 << 4 | in.r2);
+        trace->record(pc, mem[pc], ea, reg[R_A], reg[R_X] | (getCC() << 24));
+    }
+
+    // 목표 주소 (TA)
+    inline uint32_t targetAddress(const Instr &in) const {
+        uint32_t ta = in.disp;
+        if (in.flags & DF_B) ta += reg[R_B];
+        if (in.flags & DF_X) ta += reg[R_X];
+        return ta & 0xFFFFF;
+    }
+    // 피연산자 값 (immediate면 TA, indirect면 한 번 더 참조)
+    inline uint32_t operandWord(const Instr &in) {
+        uint32_t ta = targetAddress(in);
+        if (in.mode == AM_IMMEDIATE) return ta;
+        if (in.mode == AM_INDIRECT) ta = loadWord(ta) & 0xFFFFF;
+        return loadWord(ta);
+    }
+    inline uint8_t operandByte(const Instr &in) {
+        uint32_t ta = targetAddress(in);
+        if (in.mode == AM_IMMEDIATE) return ta & 0xFF;
+        if (in.mode == AM_INDIRECT) ta = loadWord(ta) & 0xFFFFF;
+        return loadByte(ta);
+    }
+    // 저장/점프 대상 주소 (indirect면 한 번 더 참조)
+    inline uint32_t effectiveAddress(const Instr &in) {
+        uint32_t ta = targetAddress(in);
+        if (in.mode == AM_INDIRECT) ta = loadWord(ta) & 0xFFFFF;
+        return ta;
+    }
+    inline void store(const Instr &in, uint32_t v) {
+        if (in.mode == AM_IMMEDIATE) { halt("store with immediate operand at " + hexPad(reg[R_PC], 6)); return; }
+        storeWord(effectiveAddress(in), v & WORD_MASK);
+    }
+    inline void jump(uint32_t pc, uint32_t target) {
+        if (target == pc) { reg[R_PC] = pc; halt("J * at " + hexPad(pc, 6)); return; } // 자기 자신으로 점프 = 종료 루프
+        reg[R_PC] = target;
+    }
+
+    /**
+     * 명령어 하나 실행 (switch 디스패치)
+     * @param pc 명령어 주소
+     */
+    void execute(uint32_t pc, const Instr &in) {
+        uint32_t *r = reg;
+        r[R_PC] = pc + in.length;
+
+        switch (in.id) {
+#define CASE_OP(name, ...) case OP_##name: { __VA_ARGS__ } break;
+        SIC_OPS(CASE_OP)
+#undef CASE_OP
+        default: unsupported(pc); break;
+        }
+    }
+
+    /**
+     * 명령어 하나 디코딩 후 실행 (캐시 없음)
+     */
+    void step() {
+        uint32_t pc = reg[R_PC];
+        Instr in;
+        if (!decode(pc, in)) return;
+        if (trace) traceInstr(pc, in);
+        execute(pc, in);
+        ++steps;
+    }
+
+    /**
+     * switch 디스패치 + 디코드 캐시
+     */
+    void runCached(uint64_t maxSteps) {
+        uint64_t limit = maxSteps ? maxSteps : UINT64_MAX;
+        while (!halted && steps < limit) {
+            uint32_t pc = reg[R_PC];
+            const Instr *e = fetch(pc, nullptr);
+            if (!e) break;
+            ++steps;
+            if (trace) traceInstr(pc, *e);
+            execute(pc, *e);
+        }
+        if (!halted && steps >= limit) halt("step limit");
+    }
+
+    /**
+     * PC가 stopAt이 될 때까지 실행 (switch 디스패치 + 디코드 캐시)
+     * @return stopAt에 도달했으면 true (종료나 명령어 수 제한이면 false)
+     */
+    bool runUntil(uint32_t stopAt, uint64_t maxSteps) {
+        uint64_t limit = maxSteps ? maxSteps : UINT64_MAX;
+        while (!halted && steps < limit) {
+            uint32_t pc = reg[R_PC];
+            if (pc == stopAt) return true;
+            const Instr *e = fetch(pc, nullptr);
+            if (!e) break;
+            ++steps;
+            if (trace) traceInstr(pc, *e);
+            execute(pc, *e);
+        }
+        if (!halted && steps >= limit) halt("step limit");
+        return false;
+    }
+
+    /**
+     * 프로파일을 모으며 실행 (switch 디스패치 + 디코드 캐시)
+     * 명령어 시작 주소마다 실행 횟수와 opCycles 추정치를 평면 배열에 더한다.
+     */
+    void runProfiled(uint64_t maxSteps) {
+        uint64_t limit = maxSteps ? maxSteps : UINT64_MAX;
+        if (profCount.empty()) { profCount.assign(memSize, 0); profCycles.assign(memSize, 0); }
+        while (!halted && steps < limit) {
+            uint32_t pc = reg[R_PC];
+            const Instr *e = fetch(pc, nullptr);
+            if (!e) break;
+            ++steps;
+            ++profCount[pc];
+            profCycles[pc] += opCycles(e->id);
+            ++opCount[e->id];
+            if (trace) traceInstr(pc, *e);
+            execute(pc, *e);
+        }
+        if (!halted && steps >= limit) halt("step limit");
+    }
+
+    /**
+     * computed-goto 스레드 디스패치 + 디코드 캐시
+     * 캐시 엔트리에 저장된 레이블로 바로 점프하고, 각 레이블 끝에서 다음 명령어로 점프한다.
+     * GCC/Clang 이외의 컴파일러에서는 runCached로 대신한다.
+     * @param labelsOut nullptr이 아니면 실행하지 않고 레이블 표만 돌려준다 (공유 캐시를 미리 채울 때)
+     */
+    void runThreaded(uint64_t maxSteps, const void *const **labelsOut = nullptr) {
+#if defined(__GNUC__)
+        static const void *const LABELS[OP_COUNT] = {
+#define LABEL_ADDR(name, ...) &&L_##name,
+            SIC_OPS(LABEL_ADDR)
+#undef LABEL_ADDR
+        };
+        if (labelsOut) { *labelsOut = LABELS; return; }
+        uint32_t *r = reg;
+        uint64_t limit = maxSteps ? maxSteps : UINT64_MAX;
+        uint32_t pc;
+        const Instr *e;
+
+        // 이전 실행 방식으로 채운 엔트리는 레이블이 없으므로 비운다
+        if (!resumeSlice) cache.dropUnlabeled();
+
+#define NEXT_INSTR() \
+        do { \
+            if (__builtin_expect(halted || steps >= limit, 0)) goto L_EXIT; \
+            pc = r[R_PC]; \
+            e = (pc < memSize && cache.entries[pc].length) ? &cache.entries[pc] : fetch(pc, LABELS); \
+            if (__builtin_expect(!e, 0)) goto L_EXIT; \
+            ++steps; \
+            if (__builtin_expect(trace != nullptr, 0)) traceInstr(pc, *e); \
+            r[R_PC] = pc + e->length; \
+            goto *e->handler; \
+        } while (0)
+
+        NEXT_INSTR();
+
+#define LABEL_OP(name, ...) L_##name: { const Instr &in = *e; (void)in; __VA_ARGS__ } NEXT_INSTR();
+        SIC_OPS(LABEL_OP)
+#undef LABEL_OP
+#undef NEXT_INSTR
+
+    L_EXIT:
+        if (!halted && steps >= limit) halt("step limit");
+#else
+        if (labelsOut) { *labelsOut = nullptr; return; }
+        runCached(maxSteps);
+#endif
+    }
+
+    /**
+     * 진입점부터 제어 흐름을 따라가며 도달할 수 있는 명령어를 미리 디코딩
+     * (여러 인스턴스가 공유할 캐시를 만들 때. 데이터 영역은 건드리지 않는다)
+     * 고정 목표 점프는 목표를, 조건 점프와 JSUB은 목표와 다음 명령어를 모두 따라간다.
+     */
+    void predecode(uint32_t entry, const void *const *handlers) {
+        vector<uint32_t> work(1, entry);
+        vector<uint8_t> seen(memSize, 0);
+        while (!work.empty()) {
+            uint32_t pc = work.back();
+            work.pop_back();
+            while (pc < memSize && !seen[pc]) {
+                seen[pc] = 1;
+                const Instr *e = fetch(pc, handlers);
+                if (!e || e->id == OP_INVALID) break;
+                uint32_t next = pc + e->length;
+                bool fixed = e->flags == 0 && e->mode != AM_INDIRECT;
+                switch (e->id) {
+                case OP_J: if (fixed) work.push_back(e->disp); next = memSize; break;
+                case OP_JEQ: case OP_JGT: case OP_JLT: case OP_JSUB: if (fixed) work.push_back(e->disp); break;
+                case OP_RSUB: case OP_SVC: case OP_UNSUPPORTED: next = memSize; break;
+                default: break;
+                }
+                pc = next;
+            }
+        }
+        halted = false; // 범위 밖 주소를 디코딩하다 멈춘 경우
+        haltReason.clear();
+    }
+
+    // 블록 번역 실행 (정의는 번역 함수들 뒤)
+    TransBlock *translate(uint32_t start);
+    void interpretBlock(uint64_t limit);
+    void runTranslated(uint64_t maxSteps);
+
+    /**
+     * 종료 조건까지 실행
+     * 실행 중 통계가 켜져 있으면 STATS_SLICE 명령어씩 나누어 실행하고, 사이마다 출력 요청을 확인한다.
+     * @param maxSteps 최대 실행 명령어 수 (0이면 제한 없음)
+     * @param mode 실행 방식
+     */
+    void run(uint64_t maxSteps, DispatchMode mode = DISPATCH_THREADED) {
+        if (!STATS_ENABLED) { runMode(maxSteps, mode); return; }
+        uint64_t limit = maxSteps ? maxSteps : UINT64_MAX;
+        for (resumeSlice = false;; resumeSlice = true) {
+            uint64_t slice = (limit > steps && limit - steps > STATS_SLICE) ? steps + STATS_SLICE : limit;
+            runMode(slice, mode);
+            if (STATS_REQUESTED) { STATS_REQUESTED = 0; printLiveStats(*this); }
+            if (!halted || haltReason != "step limit" || steps >= limit) break;
+            halted = false; // 구간 끝: 이어서 실행
+            haltReason.clear();
+        }
+        resumeSlice = false;
+    }
+
+    void runMode(uint64_t maxSteps, DispatchMode mode) {
+        if (debug && debug->hasReadWatch()) { runWatched(maxSteps); return; }
+        if (debug && mode == DISPATCH_SWITCH) mode = DISPATCH_CACHED; // 중단점은 디코드 캐시에 걸리므로
+        if (mode == DISPATCH_BLOCK) { runTranslated(maxSteps); return; }
+        if (mode == DISPATCH_THREADED) { runThreaded(maxSteps); return; }
+        if (mode == DISPATCH_CACHED) { runCached(maxSteps); return; }
+        while (!halted) {
+            if (maxSteps && steps >= maxSteps) { halt("step limit"); break; }
+            step();
+        }
+    }
+};
+
+// ---------- 블록 번역 ----------
+typedef void (*UopFn)(Cpu &, const MicroOp &);
+
+// 전용 함수로 번역하는 피연산자 형태
+enum OperandKind { OK_IMM = 0, OK_MEM = 1, OK_MEMX = 2 };
+
+// 피연산자 주소 (절대 주소 또는 절대 주소 + X)
+template<int K> static inline uint32_t uopAddr(const Cpu &c, const MicroOp &m) {
+    return K == OK_MEMX ? (m.value + c.reg[R_X]) & 0xFFFFF : m.value;
+}
+template<int K> static inline uint32_t uopWord(Cpu &c, const MicroOp &m) {
+    return K == OK_IMM ? m.value : c.loadWord(uopAddr<K>(c, m));
+}
+
+// LDA, LDX, ... / STA, STX, ... (r1 = 대상 레지스터)
+template<int K> static void uopLoad(Cpu &c, const MicroOp &m) { c.reg[m.r1] = uopWord<K>(c, m); }
+template<int K> static void uopStore(Cpu &c, const MicroOp &m) { c.storeWord(uopAddr<K>(c, m), c.reg[m.r1]); }
+template<int K> static void uopLoadChar(Cpu &c, const MicroOp &m) {
+    uint8_t v = K == OK_IMM ? (m.value & 0xFF) : c.loadByte(uopAddr<K>(c, m));
+    c.reg[R_A] = (c.reg[R_A] & 0xFFFF00) | v;
+}
+template<int K> static void uopStoreChar(Cpu &c, const MicroOp &m) { c.storeByte(uopAddr<K>(c, m), c.reg[R_A] & 0xFF); }
+
+// A 레지스터 산술/비교, TIX
+template<int OP, int K> static void uopArith(Cpu &c, const MicroOp &m) {
+    uint32_t *r = c.reg;
+    if (OP == OP_TIX) { // X를 먼저 증가시킨 뒤 피연산자를 읽는다 (SIC_OPS와 같은 순서)
+        r[R_X] = (r[R_X] + 1) & WORD_MASK;
+        c.setCC(sx24(r[R_X]), sx24(uopWord<K>(c, m)));
+        return;
+    }
+    uint32_t v = uopWord<K>(c, m);
+    switch (OP) {
+    case OP_ADD: r[R_A] = (r[R_A] + v) & WORD_MASK; break;
+    case OP_SUB: r[R_A] = (r[R_A] - v) & WORD_MASK; break;
+    case OP_AND: r[R_A] &= v; break;
+    case OP_OR: r[R_A] |= v; break;
+    case OP_COMP: c.setCC(sx24(r[R_A]), sx24(v)); break;
+    }
+}
+
+// Format 2 (r1, r2 모두 0~9이고 PC가 아닌 경우만)
+template<int OP> static void uopReg(Cpu &c, const MicroOp &m) {
+    uint32_t *r = c.reg;
+    switch (OP) {
+    case OP_ADDR: r[m.r2] = (r[m.r2] + r[m.r1]) & WORD_MASK; break;
+    case OP_SUBR: r[m.r2] = (r[m.r2] - r[m.r1]) & WORD_MASK; break;
+    case OP_COMPR: c.setCC(sx24(r[m.r1]), sx24(r[m.r2])); break;
+    case OP_CLEAR: r[m.r1] = 0; break;
+    case OP_RMO: r[m.r2] = r[m.r1]; break;
+    case OP_TIXR: r[R_X] = (r[R_X] + 1) & WORD_MASK; c.setCC(sx24(r[R_X]), sx24(r[m.r1])); break;
+    }
+}
+
+// 목표가 고정된 점프 (블록의 마지막 명령어)
+template<int OP> static void uopJump(Cpu &c, const MicroOp &m) {
+    bool take = OP == OP_J || OP == OP_JSUB ||
+                (OP == OP_JEQ && c.getCC() == CC_EQ) ||
+                (OP == OP_JGT && c.getCC() == CC_GT) ||
+                (OP == OP_JLT && c.getCC() == CC_LT);
+    if (!take) { c.reg[R_PC] = m.nextPc; return; }
+    if (OP == OP_JSUB) { c.reg[R_L] = m.nextPc; c.reg[R_PC] = m.value; return; }
+    c.jump(m.pc, m.value);
+}
+static void uopRsub(Cpu &c, const MicroOp &m) {
+    c.reg[R_PC] = m.nextPc;
+    if (c.reg[R_L] == Cpu::HALT_ADDRESS) c.halt("RSUB to loader");
+    else c.reg[R_PC] = c.reg[R_L];
+}
+
+// 그 밖의 명령어: 디코딩 결과를 switch 실행에 그대로 넘긴다
+static void uopGeneric(Cpu &c, const MicroOp &m) { c.execute(m.pc, m.in); }
+
+// 로드/저장 명령어의 대상 레지스터 (해당 없으면 -1)
+static int transferReg(OpId id) {
+    switch (id) {
+    case OP_LDA: case OP_STA: return R_A;
+    case OP_LDX: case OP_STX: return R_X;
+    case OP_LDL: case OP_STL: return R_L;
+    case OP_LDB: case OP_STB: return R_B;
+    case OP_LDS: case OP_STS: return R_S;
+    case OP_LDT: case OP_STT: return R_T;
+    case OP_STSW: return R_SW;
+    default: return -1;
+    }
+}
+static bool isStoreOp(OpId id) {
+    return id == OP_STA || id == OP_STB || id == OP_STL || id == OP_STS || id == OP_STT ||
+           id == OP_STX || id == OP_STSW || id == OP_STCH;
+}
+
+/**
+ * 디코딩된 명령어 하나를 MicroOp으로 번역
+ * 자주 쓰는 형태는 전용 함수로 바꾸고, 나머지는 uopGeneric으로 남긴다.
+ * @return 블록을 끝내는 명령어(점프, 서브루틴 호출/복귀, 종료)이면 true
+ */
+static bool specialize(const Instr &in, MicroOp &m) {
+#define KINDS(f) { f<OK_IMM>, f<OK_MEM>, f<OK_MEMX> }
+#define ARITH(op) { uopArith<op, OK_IMM>, uopArith<op, OK_MEM>, uopArith<op, OK_MEMX> }
+    static const UopFn LOAD[3] = KINDS(uopLoad), STORE[3] = KINDS(uopStore);
+    static const UopFn LDCH[3] = KINDS(uopLoadChar), STCH[3] = KINDS(uopStoreChar);
+    static const UopFn ADD[3] = ARITH(OP_ADD), SUB[3] = ARITH(OP_SUB), AND[3] = ARITH(OP_AND),
+                       OR[3] = ARITH(OP_OR), COMP[3] = ARITH(OP_COMP), TIX[3] = ARITH(OP_TIX);
+#undef KINDS
+#undef ARITH
+
+    bool direct = in.mode == AM_SIMPLE || in.mode == AM_SIC;
+    int kind = -1;
+    if (in.flags == 0 && in.mode == AM_IMMEDIATE) kind = OK_IMM;
+    else if (in.flags == 0 && direct) kind = OK_MEM;
+    else if (in.flags == DF_X && direct) kind = OK_MEMX;
+
+    m.fn = uopGeneric;
+    m.value = in.disp;
+    int reg = transferReg(in.id);
+    bool regsOk = in.r1 < 10 && in.r2 < 10 && in.r1 != R_PC && in.r2 != R_PC;
+
+    switch (in.id) {
+    case OP_LDA: case OP_LDX: case OP_LDL: case OP_LDB: case OP_LDS: case OP_LDT:
+        if (kind >= 0) { m.fn = LOAD[kind]; m.r1 = reg; }
+        break;
+    case OP_STA: case OP_STX: case OP_STL: case OP_STB: case OP_STS: case OP_STT: case OP_STSW:
+        if (kind > OK_IMM) { m.fn = STORE[kind]; m.r1 = reg; }
+        break;
+    case OP_LDCH: if (kind >= 0) m.fn = LDCH[kind]; break;
+    case OP_STCH: if (kind > OK_IMM) m.fn = STCH[kind]; break;
+    case OP_ADD:  if (kind >= 0) m.fn = ADD[kind]; break;
+    case OP_SUB:  if (kind >= 0) m.fn = SUB[kind]; break;
+    case OP_AND:  if (kind >= 0) m.fn = AND[kind]; break;
+    case OP_OR:   if (kind >= 0) m.fn = OR[kind]; break;
+    case OP_COMP: if (kind >= 0) m.fn = COMP[kind]; break;
+    case OP_TIX:  if (kind >= 0) m.fn = TIX[kind]; break;
+    case OP_ADDR:  if (regsOk) m.fn = uopReg<OP_ADDR>; break;
+    case OP_SUBR:  if (regsOk) m.fn = uopReg<OP_SUBR>; break;
+    case OP_COMPR: if (regsOk) m.fn = uopReg<OP_COMPR>; break;
+    case OP_CLEAR: if (regsOk) m.fn = uopReg<OP_CLEAR>; break;
+    case OP_RMO:   if (regsOk) m.fn = uopReg<OP_RMO>; break;
+    case OP_TIXR:  if (regsOk) m.fn = uopReg<OP_TIXR>; break;
+    // 점프: immediate 또는 단순 주소면 목표가 고정 (indirect, 인덱스, 베이스 상대는 일반 경로)
+    case OP_J:    if (kind == OK_IMM || kind == OK_MEM) m.fn = uopJump<OP_J>; return true;
+    case OP_JEQ:  if (kind == OK_IMM || kind == OK_MEM) m.fn = uopJump<OP_JEQ>; return true;
+    case OP_JGT:  if (kind == OK_IMM || kind == OK_MEM) m.fn = uopJump<OP_JGT>; return true;
+    case OP_JLT:  if (kind == OK_IMM || kind == OK_MEM) m.fn = uopJump<OP_JLT>; return true;
+    case OP_JSUB: if (kind == OK_IMM || kind == OK_MEM) m.fn = uopJump<OP_JSUB>; return true;
+    case OP_RSUB: m.fn = uopRsub; return true;
+    case OP_INVALID: case OP_UNSUPPORTED: case OP_SVC: return true;
+    case OP_BREAK: return true; // 원래 명령어가 점프일 수 있다
+    default: break;
+    }
+    return false;
+}
+
+/**
+ * start에서 시작하는 기본 블록 번역
+ * 블록 안의 명령어를 고치는 단순 주소 저장 명령이 있으면 그 명령어 뒤에서 블록을 끊는다.
+ * (인덱스/간접 주소 저장은 실행 중 pageWritten이 처리한다)
+ */
+TransBlock *Cpu::translate(uint32_t start) {
+    unique_ptr<TransBlock> b(new TransBlock);
+    b->start = start;
+    uint32_t pc = start;
+    for (int n = 0; n < BLOCK_MAX; n++) {
+        const Instr *e = fetch(pc, nullptr);
+        if (!e) break;
+        MicroOp m;
+        m.pc = pc;
+        m.nextPc = pc + e->length;
+        m.r1 = e->r1; m.r2 = e->r2;
+        m.in = *e;
+        bool term = specialize(*e, m);
+        b->ops.push_back(m);
+        pc = m.nextPc;
+        if (term) { b->endsWithJump = true; break; }
+        if (pc >= memSize) break;
+    }
+    if (b->ops.empty()) return nullptr;
+    for (size_t i = 0; i + 1 < b->ops.size(); i++) {
+        const MicroOp &m = b->ops[i];
+        if (isStoreOp(m.in.id) && m.in.flags == 0 && m.in.mode != AM_IMMEDIATE && m.in.mode != AM_INDIRECT &&
+            m.in.disp < pc && m.in.disp + 3 > start) {
+            b->ops.resize(i + 1);
+            b->endsWithJump = false;
+            pc = m.nextPc;
+            break;
+        }
+    }
+    b->end = pc;
+
+    TransBlock *raw = b.get();
+    blocks.push_back(move(b));
+    blockAt[start] = raw;
+    for (uint32_t p = start >> DecodeCache::PAGE_SHIFT; p <= (raw->end - 1) >> DecodeCache::PAGE_SHIFT && p < pageBlocks.size(); p++)
+        pageBlocks[p].push_back(raw);
+    return raw;
+}
+
+/**
+ * 아직 번역하지 않은 코드를 블록 하나만큼 해석 실행 (블록을 끝내는 명령어까지)
+ */
+void Cpu::interpretBlock(uint64_t limit) {
+    while (!halted && steps < limit) {
+        uint32_t pc = reg[R_PC];
+        const Instr *e = fetch(pc, nullptr);
+        if (!e) { if (!halted) halt("fetch failed at " + hexPad(pc, 6)); return; }
+        OpId id = e->id;
+        ++steps; ++interpretedSteps;
+        if (trace) traceInstr(pc, *e);
+        execute(pc, *e);
+        if (id == OP_J || id == OP_JEQ || id == OP_JGT || id == OP_JLT || id == OP_JSUB || id == OP_RSUB) return;
+    }
+}
+
+/**
+ * 기본 블록 번역 실행
+ * 블록 시작 주소가 HOT_COUNT번 해석 실행되면 번역하고, 이후에는 MicroOp 배열을 차례로 호출한다.
+ * 블록이 끝나면 직전 블록의 succ에서 다음 블록을 찾아 바로 이어서 실행한다.
+ * 블록 안에서 PC는 갱신하지 않고, 블록이 끝날 때(또는 중간에 멈출 때) 한 번만 맞춘다.
+ */
+void Cpu::runTranslated(uint64_t maxSteps) {
+    uint64_t limit = maxSteps ? maxSteps : UINT64_MAX;
+    if (blockAt.empty()) {
+        blockAt.assign(memSize, nullptr);
+        heat.assign(memSize, 0);
+        pageBlocks.assign(cache.codePage.size(), vector<TransBlock *>());
+    }
+
+    TransBlock *prev = nullptr;
+    while (!halted && steps < limit) {
+        uint32_t pc = reg[R_PC];
+        TransBlock *b = nullptr;
+        if (prev) {
+            for (TransBlock *s : prev->succ)
+                if (s && s->valid && s->start == pc) { b = s; ++chainHits; break; }
+        }
+        if (!b && pc < memSize) {
+            b = blockAt[pc];
+            if (!b && heat[pc] >= HOT_COUNT) b = translate(pc);
+            if (b && prev) prev->succ[(prev->succ[0] && prev->succ[0]->valid) ? 1 : 0] = b;
+        }
+        if (!b || b->ops.size() > limit - steps) {
+            if (pc < memSize && heat[pc] < HOT_COUNT) heat[pc]++;
+            interpretBlock(limit);
+            prev = nullptr;
+            continue;
+        }
+
+        stopBlock = false;
+        const MicroOp *op = b->ops.data(), *end = op + b->ops.size();
+        if (__builtin_expect(trace != nullptr, 0)) { // 추적 검사는 블록 단위로 한 번만
+            while (op != end) {
+                traceInstr(op->pc, op->in);
+                op->fn(*this, *op);
+                ++op;
+                if (stopBlock) break;
+            }
+        } else {
+            while (op != end) {
+                op->fn(*this, *op);
+                ++op;
+                if (stopBlock) break;
+            }
+        }
+        size_t n = op - b->ops.data();
+        steps += n;
+        translatedSteps += n;
+        if (stopBlock) { // 종료 또는 코드 변경: 마지막으로 실행한 명령어 다음에서 이어간다
+            if (!(op == end && b->endsWithJump)) reg[R_PC] = op[-1].nextPc;
+            prev = nullptr;
+        } else {
+            if (!b->endsWithJump) reg[R_PC] = b->end;
+            prev = b;
+        }
+    }
+    if (!halted && steps >= limit) halt("step limit");
+}
+
+/**
+ * 레지스터와 실행 통계 출력
+ */
+void printState(const Cpu &cpu, double seconds) {
+    static const char *names[] = {"A", "X", "L", "B", "S", "T", "F", "", "PC", "SW"};
+    cout << "Halted: " << cpu.haltReason << "\n";
+    for (int i = 0; i < 10; i++) {
+        if (i == R_F || names[i][0] == '\0') continue;
+        cout << setw(2) << names[i] << "=" << hexPad(cpu.reg[i], 6) << (i == R_SW ? "\n" : " ");
+    }
+    if (cpu.fReg != 0 || cpu.fRawValid)
+        cout << " F=" << hexPad(cpu.fRawValid ? cpu.fRaw : doubleToSicFloat(cpu.fReg), 12) << " (" << setprecision(12) << cpu.fReg << ")\n";
+    cout << "Instructions: " << cpu.steps << "\n";
+    cout << "Elapsed: " << fixed << setprecision(6) << seconds << " s\n";
+    cout << "IPS: " << fixed << setprecision(0) << (seconds > 0 ? cpu.steps / seconds : 0.0) << "\n";
+    if (cpu.cache.fills) cout << "Decode cache: " << cpu.cache.fills << " fills, " << cpu.cache.invalidations << " invalidations\n";
+    if (cpu.translatedSteps || cpu.interpretedSteps) {
+        cout << "Blocks: " << cpu.blocks.size() << " translated, " << cpu.blockInvalidations << " invalidated, "
+             << cpu.chainHits << " chained\n";
+        cout << "In blocks: " << cpu.translatedSteps << " instructions (" << fixed << setprecision(2)
+             << 100.0 * cpu.translatedSteps / cpu.steps << "%), interpreted: " << cpu.interpretedSteps << "\n";
+    }
+    for (int d = 0; d < 256; d++) {
+        const DeviceTable::Device &dv = cpu.devices.dev[d];
+        if (!dv.bytesRead && !dv.bytesWritten) continue;
+        double mb = (dv.bytesRead + dv.bytesWritten) / 1048576.0;
+        cout << "Device " << hexPad(d, 2) << ": read " << dv.bytesRead << " B (" << dv.fills << " fills), wrote "
+             << dv.bytesWritten << " B (" << dv.flushes << " flushes), " << fixed << setprecision(2)
+             << (seconds > 0 ? mb / seconds : 0.0) << " MB/s\n";
+    }
+}
+
+// 현재 프로세스의 RSS (KB). /proc이 없으면 0
+static long currentRssKb() {
+    ifstream ifs("/proc/self/statm");
+    long pages = 0, rss = 0;
+    if (!(ifs >> pages >> rss)) return 0;
+    return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * 실행 중 통계 한 줄을 stderr에 출력 (SIGUSR1 / -P)
+ * IPS는 직전 출력 이후 구간의 값. 여러 스레드가 동시에 써도 줄이 섞이지 않도록 write 한 번으로 출력한다.
+ */
+void printLiveStats(Cpu &cpu) {
+    auto now = chrono::steady_clock::now();
+    double elapsed = chrono::duration<double>(now - cpu.statsStart).count();
+    double interval = chrono::duration<double>(now - cpu.statsLast).count();
+    uint64_t delta = cpu.steps - cpu.statsLastSteps;
+    uint64_t devRead = 0, devWritten = 0;
+    for (auto &dv : cpu.devices.dev) { devRead += dv.bytesRead; devWritten += dv.bytesWritten; }
+    stringstream ss;
+    ss << "[stats] pid=" << getpid() << " steps=" << cpu.steps << " pc=" << hexPad(cpu.reg[R_PC], 6)
+       << fixed << setprecision(0) << " ips=" << (interval > 0 ? delta / interval : 0.0)
+       << " fills=" << cpu.cache.fills << " invalidations=" << cpu.cache.invalidations;
+    if (!cpu.blocks.empty()) ss << " blocks=" << cpu.blocks.size();
+    if (devRead || devWritten) ss << " dev_read=" << devRead << " dev_written=" << devWritten;
+    ss << " rss=" << currentRssKb() << "KB" << setprecision(2) << " elapsed=" << elapsed << "s\n";
+    string line = ss.str();
+    if (write(STDERR_FILENO, line.data(), line.size()) < 0) {}
+    cpu.statsLast = now;
+    cpu.statsLastSteps = cpu.steps;
+}
+
+static void statsSignalHandler(int) { STATS_REQUESTED = 1; }
+/**
+ * SIGUSR1 handler 설치, progressSec > 0이면 그 주기로 SIGALRM을 보내 진행 상황을 출력
+ */
+void installStatsSignals(int progressSec) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = statsSignalHandler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &sa, nullptr);
+    STATS_ENABLED = true;
+    if (progressSec <= 0) return;
+    sigaction(SIGALRM, &sa, nullptr);
+    struct itimerval it;
+    it.it_interval.tv_sec = progressSec; it.it_interval.tv_usec = 0;
+    it.it_value = it.it_interval;
+    setitimer(ITIMER_REAL, &it, nullptr);
+}
+
+// ---------- trace ----------
+// 시그널 핸들러가 덤프할 추적 버퍼와 파일 이름
+static TraceRing *TRACE_ACTIVE = nullptr;
+static char TRACE_PATH[512];
+
+/**
+ * 시뮬레이터 자체가 비정상 종료될 때(SIGSEGV 등, Ctrl+C 포함) 추적 버퍼를 저장하고
+ * 원래 동작으로 다시 시그널을 보낸다.
+ */
+static void traceSignalHandler(int sig) {
+    if (TRACE_ACTIVE) TRACE_ACTIVE->dump(TRACE_PATH);
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+void installTrace(Cpu &cpu, TraceRing &ring, const string &path) {
+    cpu.trace = &ring;
+    TRACE_ACTIVE = &ring;
+    snprintf(TRACE_PATH, sizeof(TRACE_PATH), "%s", path.c_str());
+    for (int sig : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGINT, SIGTERM}) signal(sig, traceSignalHandler);
+}
+
+/**
+ * 추적 파일 해석 (오래된 칸부터)
+ * opcode는 OPTAB으로 만든 DISPATCH 표로 거꾸로 찾아 mnemonic과 형식을 얻는다.
+ */
+int decodeTrace(const string &path) {
+    ifstream ifs(path, ios::binary);
+    if (!ifs.is_open()) {
+        cout << "cannot find trace file" << endl;
+        return 1;
+    }
+    TraceHeader h;
+    if (!ifs.read((char *)&h, sizeof(h)) || memcmp(h.magic, "SICTRC1", 8) != 0 ||
+        h.entrySize != sizeof(TraceEntry) || h.capacity == 0 || (h.capacity & (h.capacity - 1))) {
+        cout << "not a trace file: " << path << endl;
+        return 1;
+    }
+    vector<TraceEntry> ring(h.capacity);
+    if (!ifs.read((char *)ring.data(), ring.size() * sizeof(TraceEntry))) {
+        cout << "truncated trace file" << endl;
+        return 1;
+    }
+
+    static const char *regNames[] = {"A", "X", "L", "B", "S", "T", "F", "?", "PC", "SW", "?", "?", "?", "?", "?", "?"};
+    static const char CC_CHARS[] = {'<', '=', '>', '?'};
+    uint64_t count = min<uint64_t>(h.head, h.capacity);
+    cout << "Trace: " << h.head << " instructions recorded, last " << count << " shown\n";
+    cout << "       Seq PC     OP Mnemonic Operand      A      X      CC\n";
+    for (uint64_t i = h.head - count; i < h.head; i++) {
+        const TraceEntry &t = ring[i & (h.capacity - 1)];
+        uint8_t op = t.pcOp >> 24;
+        const OpInfo &info = DISPATCH[op];
+        string operand;
+        if (info.format == 2) {
+            operand = string(regNames[(t.ea >> 4) & 0xF]) + "," + regNames[t.ea & 0xF];
+        } else if (info.format == 3) {
+            int ni = op & 3;
+            operand = (ni == AM_IMMEDIATE ? "#" : ni == AM_INDIRECT ? "@" : " ") + hexPad(t.ea & 0xFFFFF, 6);
+        }
+        cout << setw(10) << i << " " << hexPad(t.pcOp & 0xFFFFFF, 6) << " " << hexPad(op, 2) << " "
+             << left << setw(8) << info.mnemonic << " " << setw(11) << operand << right << " "
+             << hexPad(t.a & WORD_MASK, 6) << " " << hexPad(t.xcc & WORD_MASK, 6) << " " << CC_CHARS[(t.xcc >> 24) & 3] << "\n";
+    }
+    return 0;
+}
+
+// ---------- batch ----------
+/**
+ * 실행 하나의 결과 (여러 입력으로 같은 이미지를 돌리는 배치용)
+ * @param spec 목록 파일의 한 줄 (장치 연결)
+ * @param ok 정상 종료 여부 (J * 또는 RSUB로 로더에 돌아옴)
+ * @param output 연결하지 않은 장치로 쓴 출력
+ * @param sharedCache 끝까지 공유 디코드 캐시만으로 실행했는지
+ */
+struct BatchRun {
+    string spec;
+    bool ok = false;
+    string haltReason;
+    uint64_t steps = 0;
+    string output;
+    bool sharedCache = false;
+};
+
+// 출력 미리보기 (제어 문자는 .)
+static string previewOutput(const string &out, size_t width) {
+    string p;
+    for (size_t i = 0; i < out.size() && p.size() < width; i++) {
+        unsigned char c = out[i];
+        p += (c >= 0x20 && c < 0x7F) ? (char)c : '.';
+    }
+    if (out.size() > width) p += "...";
+    return p;
+}
+
+/**
+ * 목록 파일의 각 줄마다 독립된 인스턴스(Memory, Cpu)를 만들어 실행하고 결과를 한 보고서로 모은다.
+ * 줄 형식: "F1=in1.txt 05=out1.txt" 처럼 장치 연결을 공백으로 나열. '='가 없는 항목은 F1 입력 파일.
+ * 연결하지 않은 장치의 출력은 결과에 모으고, 입력은 빈 입력으로 본다.
+ *
+ * 모든 인스턴스는 진입점에서 미리 채운 디코드 캐시 하나를 읽기 전용으로 공유하고,
+ * 자기 코드를 고치거나 캐시에 없는 주소를 실행하는 인스턴스만 사본을 만든다.
+ * 작업은 스레드마다 덱에 나눠 두고, 자기 덱이 비면 다른 스레드 덱의 뒤에서 훔쳐 온다.
+ * @param threads 작업 스레드 수
+ * @return 모두 정상 종료면 0
+ */
+int runBatch(Memory &image, const string &listFile, unsigned threads, uint64_t maxSteps, DispatchMode mode) {
+    vector<string> specs;
+    {
+        ifstream ifs(listFile);
+        if (!ifs.is_open()) {
+            cout << "cannot find " << listFile << endl;
+            return 1;
+        }
+        string line;
+        while (getline(ifs, line)) {
+            line = trim(line);
+            if (!line.empty() && line[0] != '.') specs.push_back(line);
+        }
+    }
+    if (specs.empty()) {
+        cout << "no runs in " << listFile << endl;
+        return 1;
+    }
+    if (threads == 0) threads = 1;
+    if (threads > specs.size()) threads = (unsigned)specs.size();
+
+    // 공유 디코드 캐시 (threaded면 레이블까지 채워 둔다)
+    uint32_t entry = (uint32_t)image.getEntryAddress();
+    Cpu seed(image);
+    const void *const *labels = nullptr;
+    if (mode == DISPATCH_THREADED) seed.runThreaded(0, &labels);
+    seed.predecode(entry, labels);
+
+    vector<BatchRun> results(specs.size());
+    struct WorkQueue { mutex m; deque<size_t> jobs; };
+    vector<WorkQueue> queues(threads);
+    for (size_t i = 0; i < specs.size(); i++) queues[i % threads].jobs.push_back(i);
+
+    auto nextJob = [&](unsigned self, size_t &job) {
+        {
+            lock_guard<mutex> lk(queues[self].m);
+            if (!queues[self].jobs.empty()) { job = queues[self].jobs.front(); queues[self].jobs.pop_front(); return true; }
+        }
+        for (unsigned k = 1; k < threads; k++) { // 다른 스레드 덱의 뒤에서 훔치기
+            WorkQueue &q = queues[(self + k) % threads];
+            lock_guard<mutex> lk(q.m);
+            if (!q.jobs.empty()) { job = q.jobs.back(); q.jobs.pop_back(); return true; }
+        }
+        return false;
+    };
+
+    auto runOne = [&](size_t idx) {
+        BatchRun &res = results[idx];
+        res.spec = specs[idx];
+        unique_ptr<Memory> memory(new Memory(image));
+        unique_ptr<Cpu> cpu(new Cpu(*memory, &seed.cache));
+        cpu->devices.captureUnmapped = true;
+        for (auto &tok : split(specs[idx])) {
+            if (tok.find('=') == string::npos) cpu->devices.map("F1=" + tok);
+            else if (!cpu->devices.map(tok)) { res.haltReason = "bad device mapping " + tok; return; }
+        }
+        cpu->reset(entry);
+        cpu->run(maxSteps, mode);
+        cpu->devices.flushAll();
+        res.haltReason = cpu->haltReason;
+        res.ok = cpu->haltReason == "RSUB to loader" || cpu->haltReason.compare(0, 4, "J * ") == 0;
+        res.steps = cpu->steps;
+        res.output = cpu->devices.captured;
+        res.sharedCache = cpu->cache.shared;
+    };
+
+    auto t0 = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back([&, t]() {
+            size_t job;
+            while (nextJob(t, job)) runOne(job);
+        });
+    }
+    for (auto &th : pool) th.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    uint64_t totalSteps = 0;
+    size_t failed = 0, shared = 0;
+    for (auto &r : results) {
+        totalSteps += r.steps;
+        if (!r.ok) failed++;
+        if (r.sharedCache) shared++;
+    }
+    cout << "=== Batch: " << results.size() << " runs, " << threads << " threads ===\n";
+    cout << "   # Status  Instructions  Output (bytes)  Input / halt reason\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BatchRun &r = results[i];
+        cout << setw(4) << i + 1 << " " << (r.ok ? "OK    " : "FAIL  ") << " " << setw(12) << r.steps << "  "
+             << setw(14) << r.output.size() << "  " << r.spec << "\n";
+        cout << "       " << r.haltReason;
+        if (!r.output.empty()) cout << " | " << previewOutput(r.output, 40);
+        cout << "\n";
+    }
+    cout << "Failed: " << failed << "/" << results.size() << "\n";
+    cout << "Shared decode cache: " << shared << "/" << results.size() << " runs (" << seed.cache.fills << " entries predecoded)\n";
+    cout << "Elapsed: " << fixed << setprecision(6) << seconds << " s\n";
+    cout << "IPS: " << fixed << setprecision(0) << (seconds > 0 ? totalSteps / seconds : 0.0)
+         << ", runs/s: " << fixed << setprecision(1) << (seconds > 0 ? results.size() / seconds : 0.0) << "\n";
+    return failed ? 1 : 0;
+}
+
+// ---------- what-if ----------
+/**
+ * 체크포인트 이후 자식 하나에 적용할 설정
+ * 형식: 쉼표로 구분한 항목
+ *   A=1F       레지스터 (A, X, L, B, S, T, PC, SW; 16진수)
+ *   @1030=5    메모리 워드 (실행 주소; 16진수)
+ *   F1<in.txt  입력 장치를 다른 파일로
+ */
+struct WhatIfVariant {
+    string spec;
+    vector<pair<int, uint32_t>> regs;
+    vector<pair<uint32_t, uint32_t>> words;
+    vector<pair<uint8_t, string>> inputs;
+};
+
+bool parseVariant(const string &spec, WhatIfVariant &v) {
+    v.spec = spec;
+    stringstream ss(spec);
+    string item;
+    while (getline(ss, item, ',')) {
+        item = trim(item);
+        if (item.empty()) continue;
+        size_t lt = item.find('<'), eq = item.find('=');
+        if (lt != string::npos && lt > 0 && lt <= 2) {
+            v.inputs.push_back({(uint8_t)hexstrToHex(item.substr(0, lt)), item.substr(lt + 1)});
+        } else if (eq != string::npos && item[0] == '@') {
+            v.words.push_back({(uint32_t)hexstrToHex(item.substr(1, eq - 1)), (uint32_t)hexstrToHex(item.substr(eq + 1)) & WORD_MASK});
+        } else if (eq != string::npos && REGNUM.count(toUpper(item.substr(0, eq))) && toUpper(item.substr(0, eq)) != "F") {
+            v.regs.push_back({REGNUM[toUpper(item.substr(0, eq))], (uint32_t)hexstrToHex(item.substr(eq + 1)) & WORD_MASK});
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 자식이 파이프로 돌려주는 결과 (PIPE_BUF보다 작아 한 번의 write가 섞이지 않는다)
+ */
+struct WhatIfResult {
+    int32_t variant;
+    int32_t ok; // 설정 적용 성공 여부
+    uint32_t reg[10];
+    uint64_t steps; // 체크포인트 이후 실행한 명령어 수
+    char haltReason[96];
+};
+
+/**
+ * 체크포인트에서 변형마다 fork해 나머지를 실행하고 결과를 모아 출력
+ * 자식은 부모의 메모리, 레지스터, 디코드 캐시를 copy-on-write로 이어받으므로
+ * 체크포인트까지의 실행은 한 번만 한다. 결과는 하나의 ctp 파이프로 돌아온다.
+ * cpuBudget > 0이면 자식마다 RLIMIT_CPU를 걸어 끝나지 않는 변형이 CPU를 계속 쓰지 못하게 한다.
+ */
+int runWhatIf(Cpu &cpu, const vector<WhatIfVariant> &variants, uint64_t maxSteps, DispatchMode mode, int cpuBudget) {
+    int ctp[2];
+    if (pipe(ctp) == -1) {
+        perror("pipe: ctp error");
+        return 1;
+    }
+    cpu.devices.flushAll();
+    fflush(stdout);
+    cout.flush();
+
+    uint32_t checkpoint = cpu.reg[R_PC];
+    uint64_t base = cpu.steps;
+    vector<pid_t> pids(variants.size(), -1);
+    for (size_t i = 0; i < variants.size(); i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fail to fork");
+            continue;
+        }
+        if (pid == 0) { // 자식: 설정 적용 후 끝까지 실행
+            close(ctp[0]);
+            if (cpuBudget > 0) { // CPU 시간은 fork할 때 0부터 다시 센다
+                struct rlimit rl;
+                getrlimit(RLIMIT_CPU, &rl);
+                rl.rlim_cur = (rlim_t)cpuBudget;
+                if (rl.rlim_max != RLIM_INFINITY && rl.rlim_cur > rl.rlim_max) rl.rlim_cur = rl.rlim_max;
+                setrlimit(RLIMIT_CPU, &rl);
+            }
+            const WhatIfVariant &v = variants[i];
+            cpu.devices.detach((int)i + 1);
+            for (auto &r : v.regs) cpu.reg[r.first] = r.second;
+            for (auto &w : v.words) cpu.storeWord(w.first, w.second);
+            for (auto &in : v.inputs) cpu.devices.remapInput(in.first, in.second);
+
+            WhatIfResult res;
+            memset(&res, 0, sizeof(res));
+            res.variant = (int32_t)i;
+            res.ok = !cpu.halted;
+            if (!cpu.halted) cpu.run(maxSteps ? base + maxSteps : 0, mode);
+            cpu.devices.flushAll();
+            fflush(stdout);
+            memcpy(res.reg, cpu.reg, sizeof(res.reg));
+            res.steps = cpu.steps - base;
+            strncpy(res.haltReason, cpu.haltReason.c_str(), sizeof(res.haltReason) - 1);
+
+            if (write(ctp[1], &res, sizeof(res)) != (ssize_t)sizeof(res)) _exit(1);
+            close(ctp[1]);
+            _exit(0);
+        }
+        pids[i] = pid;
+    }
+    close(ctp[1]);
+
+    // 끝난 순서대로 도착하는 결과를 변형 번호 자리에 모은다
+    vector<WhatIfResult> results(variants.size());
+    vector<bool> got(variants.size(), false);
+    WhatIfResult res;
+    while (read(ctp[0], &res, sizeof(res)) == (ssize_t)sizeof(res)) {
+        if (res.variant >= 0 && (size_t)res.variant < variants.size()) {
+            results[res.variant] = res;
+            got[res.variant] = true;
+        }
+    }
+    close(ctp[0]);
+
+    vector<int> statuses(variants.size(), 0);
+    for (size_t i = 0; i < pids.size(); i++) if (pids[i] > 0) waitpid(pids[i], &statuses[i], 0);
+
+    cout << "\n=== What-if from checkpoint " << hexPad(checkpoint, 6) << " (" << base << " instructions shared) ===\n";
+    for (size_t i = 0; i < variants.size(); i++) {
+        cout << "[" << i + 1 << "] " << (variants[i].spec.empty() ? "(unchanged)" : variants[i].spec) << "\n    ";
+        if (!got[i]) {
+            if (pids[i] < 0) cout << "not started\n";
+            else if (WIFSIGNALED(statuses[i]) && WTERMSIG(statuses[i]) == SIGXCPU) cout << "CPU limit exceeded (" << cpuBudget << "s)\n";
+            else if (WIFSIGNALED(statuses[i])) cout << "killed by signal " << WTERMSIG(statuses[i]) << "\n";
+            else cout << "no result (exit " << WEXITSTATUS(statuses[i]) << ")\n";
+            continue;
+        }
+        const WhatIfResult &r = results[i];
+        cout << "Halted: " << r.haltReason << ", " << r.steps << " instructions\n    ";
+        static const char *names[] = {"A", "X", "L", "B", "S", "T", "F", "", "PC", "SW"};
+        for (int k = 0; k < 10; k++) {
+            if (k == R_F || names[k][0] == '\0') continue;
+            cout << setw(2) << names[k] << "=" << hexPad(r.reg[k], 6) << (k == R_SW ? "\n" : " ");
+        }
+    }
+    return 0;
+}
+
+// ---------- profile report ----------
+/**
+ * INTFILE.txt 한 줄 (어셈블러 pass 1 출력)
+ * 형식: 줄번호 주소 [블록] 레이블(8칸) opcode(8칸) operand
+ */
+struct SourceLine {
+    int lineNo;
+    uint32_t addr;
+    string block, label, opcode, operand;
+};
+
+/**
+ * INTFILE.txt 읽기
+ * 주석 줄은 건너뛰고, 두 번째 제어 섹션(CSECT)부터는 주소가 다시 0에서 시작하므로 읽지 않는다.
+ */
+bool readIntfile(const string &name, vector<SourceLine> &lines) {
+    ifstream ifs(name);
+    if (!ifs.is_open()) {
+        cout << "cannot find " << name << endl;
+        return false;
+    }
+    string line;
+    while (getline(ifs, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t lb = line.find(" ["), rb = line.find("] ");
+        if (lb == string::npos || rb == string::npos || rb < lb) continue; // 주석 줄
+        auto head = split(line.substr(0, lb));
+        if (head.size() != 2) continue;
+
+        SourceLine sl;
+        sl.lineNo = atoi(head[0].c_str());
+        sl.addr = (uint32_t)hexstrToHex(head[1]);
+        sl.block = line.substr(lb + 2, rb - lb - 2);
+        string rest = line.substr(rb + 2);
+        if (rest.size() > 8 && rest[8] == ' ') { // 레이블이 8칸 안에 들어가는 경우
+            sl.label = trim(rest.substr(0, 8));
+            rest = rest.substr(9);
+        } else {
+            auto toks = split(rest);
+            sl.label = toks.empty() ? "" : toks[0];
+            rest = rest.substr(rest.find(sl.label) + sl.label.size());
+        }
+        rest = trim(rest);
+        size_t sp = rest.find(' ');
+        sl.opcode = rest.substr(0, sp);
+        sl.operand = sp == string::npos ? "" : trim(rest.substr(sp + 1));
+        if (toUpper(sl.opcode) == "CSECT") break;
+        lines.push_back(sl);
+    }
+    return true;
+}
+
+/**
+ * 소스 줄별 실행 횟수/예상 사이클 보고서
+ * INTFILE의 주소는 어셈블 주소이므로 (로드 주소 - 프로그램 시작 주소)만큼 옮겨 실행 주소와 맞춘다.
+ * @param top 출력할 줄 수 (0이면 전부)
+ */
+void printProfile(const Cpu &cpu, const Memory &memory, const vector<SourceLine> &lines, size_t top) {
+    if (cpu.profCount.empty()) return;
+    uint32_t offset = (uint32_t)(memory.getLoadAddress() - memory.getProgramStart());
+
+    // 실행 주소 -> INTFILE 줄 (명령어 첫 바이트에만 표시, 코드를 만들지 않는 지시어는 제외)
+    static const unordered_set<string> NO_CODE = {"START","END","BASE","NOBASE","EQU","ORG","USE","LTORG","EXTDEF","EXTREF"};
+    vector<int> lineAt(cpu.memSize, -1);
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (NO_CODE.count(toUpper(lines[i].opcode))) continue;
+        uint32_t a = lines[i].addr + offset;
+        if (a < cpu.memSize && lineAt[a] < 0) lineAt[a] = (int)i;
+    }
+
+    uint64_t totalCycles = 0;
+    vector<uint32_t> hot;
+    for (uint32_t a = 0; a < cpu.memSize; a++) {
+        if (!cpu.profCount[a]) continue;
+        hot.push_back(a);
+        totalCycles += cpu.profCycles[a];
+    }
+    sort(hot.begin(), hot.end(), [&](uint32_t x, uint32_t y) {
+        return cpu.profCycles[x] != cpu.profCycles[y] ? cpu.profCycles[x] > cpu.profCycles[y] : x < y;
+    });
+    if (top && hot.size() > top) hot.resize(top);
+
+    cout << "\n=== Profile ===\n";
+    cout << "Estimated cycles: " << totalCycles << "\n";
+    cout << " Line Address        Count       Cycles      %  Source\n";
+    for (uint32_t a : hot) {
+        int li = lineAt[a];
+        cout << setw(5) << (li >= 0 ? to_string(lines[li].lineNo) : string("?")) << " "
+             << setw(7) << hexPad(a, 6) << " " << setw(12) << cpu.profCount[a] << " " << setw(12) << cpu.profCycles[a] << " "
+             << fixed << setprecision(2) << setw(6) << (totalCycles ? 100.0 * cpu.profCycles[a] / totalCycles : 0.0) << "  ";
+        if (li >= 0) {
+            const SourceLine &sl = lines[li];
+            cout << setw(8) << sl.label << " " << setw(8) << sl.opcode << (sl.operand.empty() ? "" : " " + sl.operand);
+        }
+        cout << "\n";
+    }
+
+    cout << "\nBy opcode:\n";
+    vector<int> ids;
+    for (int id = 0; id < OP_COUNT; id++) if (cpu.opCount[id]) ids.push_back(id);
+    sort(ids.begin(), ids.end(), [&](int x, int y) {
+        return cpu.opCount[x] * opCycles((OpId)x) > cpu.opCount[y] * opCycles((OpId)y);
+    });
+    for (int id : ids) {
+        cout << setw(8) << OPID_NAMES[id] << " " << setw(12) << cpu.opCount[id] << " "
+             << setw(12) << cpu.opCount[id] * opCycles((OpId)id) << "\n";
+    }
+}
+
+/**
+ * 사용법: simulator [-o optab.txt] [-n 최대명령어수] [-d switch|cached|threaded|block] [-p INTFILE.txt [-t 줄수]] [-D 장치=파일]... [-k 주소 [-v 설정]... [-L CPU초]] [-x TRACE.bin] [-B 중단점]... [-W 감시점]... [-M 목록 [-j 스레드]] objfile 로드주소
+ *        simulator [-o optab.txt] -X TRACE.bin
+ * -d: 실행 방식 (기본 threaded). switch는 매 명령어를 새로 디코딩하는 기준 구현, block은 기본 블록 번역
+ * -p: 프로파일 모드. 주소별 실행 횟수를 모아 INTFILE.txt의 소스 줄과 맞춰 출력한다 ('-'이면 소스 없이 주소만)
+ * -t: 프로파일에 출력할 줄 수 (기본 20, 0이면 전부)
+ * -D: 장치 연결 (예: -D F1=input.txt -D 05=output.txt). 연결하지 않은 장치는 표준 입력/출력
+ * -k: 체크포인트 실행 주소. 여기까지 한 번 실행한 뒤 -v 변형마다 fork해서 나머지를 실행한다
+ * -v: 변형 설정 (예: -v "A=5,@1030=10" -v "F1<other.txt"). -k만 주면 변형 없이 한 번
+ * -L: 변형 하나가 쓸 수 있는 CPU 시간(초). 넘기면 커널이 SIGXCPU로 그 변형만 끝낸다
+ * -x: 실행 추적을 링 버퍼에 기록하고 종료(또는 비정상 종료) 때 파일로 저장
+ * -X: 저장한 추적 파일을 해석해서 출력 (obj 파일 없이 optab만 필요)
+ * -B: 중단점 (예: -B 1009, -B 1009:X=64). 실행 주소에 도달하면 그 명령어를 실행하기 전에 멈춘다
+ * -W: 감시점 (예: -W 1030, -W 1030-1035:rw). 기본은 쓰기 감시
+ * -M: 목록 파일의 줄마다 장치 연결을 바꿔 독립 인스턴스로 실행하고 보고서 하나로 모은다 (-pthread로 빌드)
+ * -j: -M 실행에 쓸 스레드 수 (기본: 코어 수)
+ * 인자가 없으면 표준 입력으로 obj 파일과 로드 주소를 받는다.
+ */
+/**
+ * 옵션 값(0 이상 10진수 정수) 파싱. 숫자가 아니거나 max보다 크면 false
+ */
+static bool parseCount(const char *s, uint64_t max, uint64_t &out) {
+    if (!*s || *s == '-' || *s == '+') return false;
+    char *end = nullptr;
+    errno = 0;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (*end != '\0' || errno == ERANGE || v > max) return false;
+    out = v;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    string optabFile = "optab.txt";
+    uint64_t maxSteps = 0;
+    DispatchMode mode = DISPATCH_THREADED;
+    string profileSource;
+    bool profile = false;
+    size_t profileTop = 20;
+    vector<string> deviceSpecs;
+    bool whatIf = false;
+    uint32_t checkpoint = 0;
+    vector<WhatIfVariant> variants;
+    string traceFile, decodeFile;
+    Debugger debugger;
+    string batchList;
+    unsigned batchThreads = thread::hardware_concurrency();
+    int progressSec = 0;
+    int cpuBudget = 0;
+    vector<string> args;
+    // 숫자 옵션 값 확인: 잘못되면 사용법을 출력하고 종료 코드 2
+    auto count = [&](const char *opt, const char *val, uint64_t max, uint64_t &out) {
+        if (parseCount(val, max, out)) return true;
+        cerr << "Bad " << opt << " value: " << val << "\n"
+             << "usage: simulator [-o optab.txt] [-n steps] [-d switch|cached|threaded|block] [-p INTFILE.txt [-t lines]] "
+                "[-k addr [-v spec]... [-L cpusec]] [-B break]... [-W watch]... [-M list [-j threads]] [-P sec] objfile loadaddr\n";
+        return false;
+    };
+    uint64_t v;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) optabFile = argv[++i];
+        else if (arg == "-n" && i + 1 < argc) { if (!count("-n", argv[++i], UINT64_MAX, maxSteps)) return 2; }
+        else if (arg == "-d" && i + 1 < argc) {
+            string m = argv[++i];
+            mode = (m == "switch") ? DISPATCH_SWITCH : (m == "cached") ? DISPATCH_CACHED :
+                   (m == "block") ? DISPATCH_BLOCK : DISPATCH_THREADED;
+        }
+        else if (arg == "-p" && i + 1 < argc) { profile = true; profileSource = argv[++i]; }
+        else if (arg == "-t" && i + 1 < argc) { if (!count("-t", argv[++i], SIZE_MAX, v)) return 2; profileTop = (size_t)v; }
+        else if (arg == "-D" && i + 1 < argc) deviceSpecs.push_back(argv[++i]);
+        else if (arg == "-x" && i + 1 < argc) traceFile = argv[++i];
+        else if (arg == "-X" && i + 1 < argc) decodeFile = argv[++i];
+        else if (arg == "-B" && i + 1 < argc) {
+            Breakpoint b;
+            if (!parseBreakpoint(argv[++i], b)) { cerr << "Bad breakpoint " << argv[i] << "\n"; return 2; }
+            debugger.breaks.push_back(b);
+        }
+        else if (arg == "-W" && i + 1 < argc) {
+            Watchpoint w;
+            if (!parseWatchpoint(argv[++i], w)) { cerr << "Bad watchpoint " << argv[i] << "\n"; return 2; }
+            debugger.watches.push_back(w);
+        }
+        else if (arg == "-M" && i + 1 < argc) batchList = argv[++i];
+        else if (arg == "-j" && i + 1 < argc) { if (!count("-j", argv[++i], 4096, v)) return 2; batchThreads = (unsigned)v; }
+        else if (arg == "-P" && i + 1 < argc) { if (!count("-P", argv[++i], INT_MAX, v)) return 2; progressSec = (int)v; }
+        else if (arg == "-L" && i + 1 < argc) { if (!count("-L", argv[++i], INT_MAX, v)) return 2; cpuBudget = (int)v; }
+        else if (arg == "-k" && i + 1 < argc) { whatIf = true; checkpoint = (uint32_t)hexstrToHex(argv[++i]); }
+        else if (arg == "-v" && i + 1 < argc) {
+            WhatIfVariant v;
+            if (!parseVariant(argv[++i], v)) { cerr << "Bad variant " << argv[i] << "\n"; return 2; }
+            variants.push_back(v);
+        }
+        else args.push_back(arg);
+    }
+
+    if (!loadOptab(optabFile)) { cerr << "Failed to load " << optabFile << "\n"; return 2; }
+    buildDispatch();
+    if (!decodeFile.empty()) return decodeTrace(decodeFile);
+    installStatsSignals(progressSec);
+
+    string file, inputStart;
+    if (args.size() >= 2) {
+        file = args[0];
+        inputStart = args[1];
+    } else {
+        cout << "objfile 이름 입력: ";
+        getline(cin, file);
+        cout << "프로그램 시작 주소 입력: ";
+        cin >> inputStart;
+    }
+
+    Memory memory;
+    memory.setLoadAddress(hexstrToHex(inputStart));
+    if (!fileRead(file, memory)) return 1;
+
+    if (!batchList.empty()) return runBatch(memory, batchList, batchThreads, maxSteps, mode);
+
+    Cpu cpu(memory);
+    cpu.reset((uint32_t)memory.getEntryAddress());
+    for (auto &spec : deviceSpecs) {
+        if (!cpu.devices.map(spec)) { cerr << "Bad device mapping " << spec << "\n"; return 2; }
+    }
+    if (!debugger.breaks.empty() || !debugger.watches.empty()) cpu.attachDebugger(debugger);
+    unique_ptr<TraceRing> ring;
+    if (!traceFile.empty()) {
+        ring.reset(new TraceRing());
+        installTrace(cpu, *ring, traceFile);
+    }
+    auto dumpTrace = [&]() {
+        if (!ring) return;
+        if (ring->dump(traceFile.c_str())) cout << "Trace: " << ring->head.load() << " instructions, saved to " << traceFile << "\n";
+        else cout << "cannot write " << traceFile << endl;
+    };
+
+    if (whatIf) {
+        if (!cpu.runUntil(checkpoint, maxSteps)) {
+            cpu.devices.flushAll();
+            fflush(stdout);
+            cout << "checkpoint " << hexPad(checkpoint, 6) << " not reached\n";
+            printState(cpu, 0);
+            dumpTrace();
+            return 1;
+        }
+        dumpTrace();
+        if (variants.empty()) variants.push_back(WhatIfVariant());
+        return runWhatIf(cpu, variants, maxSteps, mode, cpuBudget);
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    if (profile) cpu.runProfiled(maxSteps);
+    else cpu.run(maxSteps, mode);
+    cpu.devices.flushAll();
+    auto t1 = chrono::steady_clock::now();
+    fflush(stdout);
+
+    printState(cpu, chrono::duration<double>(t1 - t0).count());
+    dumpTrace();
+    if (profile) {
+        vector<SourceLine> lines;
+        if (profileSource != "-") readIntfile(profileSource, lines);
+        printProfile(cpu, memory, lines, profileTop);
+    }
+    return 0;
+}
@@ -5,6 +5,17 @@
 #include <string>
 #include <vector>
 #include <bitset>
+#include <cstring>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 using namespace std;
 
 // 문자열 앞뒤 공백 제거
@@ -50,21 +61,46 @@ string hexstrToBin(char hexChar) {
  * Memory 클래스
  */
 class Memory {
+public:
+    static const size_t MEM_SIZE = 32758;
+
 private:
-    char mem[32758] = { 0 };
+    char storage[MEM_SIZE] = { 0 };
+    char *mem = storage; // 사용 중인 메모리. 스냅샷을 mmap하면 매핑된 영역을 가리킴
+    void *mapping = nullptr; // mmap된 스냅샷 파일 전체 (없으면 nullptr)
+    size_t mappingLength = 0;
     string programName; // 프로그램 이름
     size_t programStart = 0; // 프로그램 논리적 시작 주소
     size_t loadAddress = 0; // 프로그램이 실제로 로드되는 주소
     size_t programLength = 0; // 프로그램 길이
 
 public:
+    Memory() = default;
+    Memory(const Memory &) = delete;
+    Memory &operator=(const Memory &) = delete;
+    ~Memory() { if (mapping) munmap(mapping, mappingLength); }
+
     /** 메모리 read/write */
     void writeByte(size_t address, unsigned char value) { mem[address] = value; }
     unsigned char readByte(size_t address) const { return mem[address]; }
 
     /** 메모리 관련 */
     char* getMemPtr() { return mem; }
-    size_t getMemSize() const { return sizeof(mem); }
+    size_t getMemSize() const { return MEM_SIZE; }
+
+    /**
+     * mmap된 스냅샷을 메모리로 사용
+     * MAP_PRIVATE 매핑이므로 쓰기는 copy-on-write로 처리되어 스냅샷 파일은 바뀌지 않는다.
+     * @param base 매핑 시작 주소
+     * @param length 매핑 길이
+     * @param memOffset 매핑 안에서 메모리 이미지가 시작하는 위치
+     */
+    void attachMapping(void *base, size_t length, size_t memOffset) {
+        if (mapping) munmap(mapping, mappingLength);
+        mapping = base;
+        mappingLength = length;
+        mem = (char *)base + memOffset;
+    }
 
     /** getter / setter */
     void setProgramName(const string &name) { programName = name; }
@@ -235,40 +271,371 @@ void EParse(string record, Memory &memory) {
     return;
 }
 
-void printMemory(Memory &memory) {       
-    ofstream memoryf("Memory State.txt");
-    
-    for (int i = 0; i < memory.getMemSize(); i++) {
-        if (i % 8 == 0) {
-            memoryf << "\n"
-                 << uppercase
-                 << hex << setw(6) << setfill('0') 
-                 << i 
-                 << ":";
-            
-            cout << "\n"
-                 << uppercase
-                 << hex << setw(6) << setfill('0') 
-                 << i 
-                 << ":";
+/**
+ * 메모리 덤프 옵션
+ * @param from 덤프 시작 주소 (포함)
+ * @param to 덤프 끝 주소 (미포함)
+ * @param toConsole cout에도 출력할지 여부
+ * @param imageFile 비어 있지 않으면 [from, to) 범위를 raw 바이너리 이미지로 저장
+ */
+struct DumpOptions {
+    size_t from = 0;
+    size_t to = 0;
+    bool toConsole = true;
+    string imageFile;
+};
+
+/**
+ * 덤프 출력 버퍼
+ * 한 바이트씩 iostream에 쓰지 않고 큰 버퍼에 모았다가 한 번에 파일/cout으로 내보낸다.
+ */
+class DumpBuffer {
+private:
+    static const size_t FLUSH_SIZE = 1 << 16; // 64KB마다 내보냄
+    vector<char> buf;
+    ofstream &file;
+    bool toConsole;
+
+public:
+    DumpBuffer(ofstream &f, bool console) : file(f), toConsole(console) { buf.reserve(FLUSH_SIZE + 128); }
+    ~DumpBuffer() { flush(); }
+
+    void append(const char *p, size_t n) {
+        buf.insert(buf.end(), p, p + n);
+        if (buf.size() >= FLUSH_SIZE) flush();
+    }
+    void flush() {
+        if (buf.empty()) return;
+        file.write(buf.data(), buf.size());
+        if (toConsole) cout.write(buf.data(), buf.size());
+        buf.clear();
+    }
+};
+
+// 주소 한 줄 포매팅: "AAAAAA: XX XX ... XX\n" (count 바이트), 작성한 길이 반환
+static size_t formatDumpLine(char *out, size_t address, const unsigned char *bytes, size_t count) {
+    static const char HEX[] = "0123456789ABCDEF";
+    size_t n = 0;
+    for (int shift = 20; shift >= 0; shift -= 4) out[n++] = HEX[(address >> shift) & 0xF];
+    out[n++] = ':';
+    for (size_t i = 0; i < count; i++) {
+        out[n++] = ' ';
+        out[n++] = HEX[bytes[i] >> 4];
+        out[n++] = HEX[bytes[i] & 0xF];
+    }
+    out[n++] = '\n';
+    return n;
+}
+
+/**
+ * [from, to) 범위의 메모리를 "Memory State.txt"(와 cout)에 출력
+ * 직전 줄과 같은 내용이 반복되면 (0으로 채워진 줄 포함) "*" 한 줄로 접고,
+ * 마지막에 끝 주소를 출력한다.
+ */
+void printMemory(Memory &memory, const DumpOptions &opt) {
+    const size_t LINE = 16; // 한 줄에 출력할 바이트 수
+    size_t from = min(opt.from, memory.getMemSize());
+    size_t to = min(opt.to, memory.getMemSize());
+    const unsigned char *mem = (const unsigned char *)memory.getMemPtr();
+
+    ofstream memoryf("Memory State.txt", ios::binary);
+    {
+        DumpBuffer out(memoryf, opt.toConsole);
+        char line[8 + LINE * 3 + 2];
+        const unsigned char *prev = nullptr;
+        bool skipping = false;
+
+        for (size_t addr = from; addr < to; addr += LINE) {
+            size_t count = min(LINE, to - addr);
+            const unsigned char *cur = mem + addr;
+            if (prev && count == LINE && memcmp(prev, cur, LINE) == 0) {
+                if (!skipping) { out.append("*\n", 2); skipping = true; }
+                continue;
+            }
+            skipping = false;
+            out.append(line, formatDumpLine(line, addr, cur, count));
+            prev = (count == LINE) ? cur : nullptr;
         }
-        memoryf << uppercase
-             << hex << setw(2) << setfill('0') 
-             << (int)(unsigned char)memory.readByte(i) << " ";
+        // 끝 주소
+        size_t n = formatDumpLine(line, to, nullptr, 0);
+        out.append(line, n);
+    }
+    memoryf.close();
+
+    // raw 바이너리 이미지
+    if (!opt.imageFile.empty() && from < to) {
+        ofstream img(opt.imageFile, ios::binary);
+        if (!img.is_open()) cout << "cannot write image file: " << opt.imageFile << endl;
+        else img.write((const char *)mem + from, to - from);
+    }
+}
+
+/**
+ * 메모리 스냅샷 파일 헤더
+ * 헤더 뒤를 SNAPSHOT_MEM_OFFSET까지 0으로 채우고 메모리 이미지를 그대로 저장한다.
+ * 이미지가 페이지 경계에서 시작하므로 mmap으로 바로 매핑할 수 있다.
+ * @param objName, objSize, objMtime 스냅샷을 만든 obj 파일과 그 상태 (바뀌면 스냅샷 무효)
+ */
+struct SnapshotHeader {
+    char magic[8];
+    uint64_t memSize;
+    uint64_t programStart;
+    uint64_t loadAddress;
+    uint64_t programLength;
+    char programName[16];
+    uint64_t objSize;
+    int64_t objMtimeSec;
+    int64_t objMtimeNsec;
+    char objName[256];
+};
+static const char SNAPSHOT_MAGIC[8] = { 'S', 'I', 'C', 'S', 'N', 'A', 'P', '1' };
+static const size_t SNAPSHOT_MEM_OFFSET = 4096;
+
+// obj 파일 상태를 헤더에 기록
+static bool fillObjStat(SnapshotHeader &h, const string &objName) {
+    struct stat st;
+    if (stat(objName.c_str(), &st) != 0) return false;
+    h.objSize = (uint64_t)st.st_size;
+    h.objMtimeSec = (int64_t)st.st_mtim.tv_sec;
+    h.objMtimeNsec = (int64_t)st.st_mtim.tv_nsec;
+    strncpy(h.objName, objName.c_str(), sizeof(h.objName) - 1);
+    return true;
+}
+
+/**
+ * 재배치까지 끝난 메모리와 프로그램 정보를 스냅샷 파일로 저장
+ * 임시 파일에 쓴 뒤 rename하므로 동시에 읽는 다른 프로세스가 중간 상태를 보지 않는다.
+ */
+bool saveSnapshot(Memory &memory, const string &snapFile, const string &objName) {
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.memSize = memory.getMemSize();
+    h.programStart = memory.getProgramStart();
+    h.loadAddress = memory.getLoadAddress();
+    h.programLength = memory.getProgramLength();
+    strncpy(h.programName, memory.getProgramName().c_str(), sizeof(h.programName) - 1);
+    if (!fillObjStat(h, objName)) return false;
+
+    string tmp = snapFile + ".tmp";
+    ofstream out(tmp, ios::binary);
+    if (!out.is_open()) return false;
+    vector<char> page(SNAPSHOT_MEM_OFFSET, 0);
+    memcpy(page.data(), &h, sizeof(h));
+    out.write(page.data(), page.size());
+    out.write(memory.getMemPtr(), memory.getMemSize());
+    out.close();
+    if (!out) return false;
+    return rename(tmp.c_str(), snapFile.c_str()) == 0;
+}
 
-        cout << uppercase
-             << hex << setw(2) << setfill('0') 
-             << (int)(unsigned char)memory.readByte(i) << " ";
+/**
+ * 스냅샷을 MAP_PRIVATE으로 매핑하여 메모리로 사용 (obj 파싱 생략)
+ * obj 파일이나 로드 주소가 스냅샷을 만들 때와 다르면 false
+ */
+bool loadSnapshot(Memory &memory, const string &snapFile, const string &objName, size_t loadAddress) {
+    int fd = open(snapFile.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < SNAPSHOT_MEM_OFFSET + memory.getMemSize()) {
+        close(fd);
+        return false;
+    }
+    size_t length = (size_t)st.st_size;
+    void *base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+    SnapshotHeader h;
+    memcpy(&h, base, sizeof(h));
+    SnapshotHeader cur;
+    memset(&cur, 0, sizeof(cur));
+    bool valid = memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) == 0
+        && h.memSize == memory.getMemSize()
+        && h.loadAddress == loadAddress
+        && fillObjStat(cur, objName)
+        && strncmp(h.objName, cur.objName, sizeof(h.objName)) == 0
+        && h.objSize == cur.objSize && h.objMtimeSec == cur.objMtimeSec && h.objMtimeNsec == cur.objMtimeNsec;
+    if (!valid) {
+        munmap(base, length);
+        return false;
     }
-    cout << endl;
+
+    memory.attachMapping(base, length, SNAPSHOT_MEM_OFFSET);
+    h.programName[sizeof(h.programName) - 1] = '\0';
+    memory.setProgramName(h.programName);
+    memory.setProgramStart(h.programStart);
+    memory.setLoadAddress(h.loadAddress);
+    memory.setProgramLength(h.programLength);
+    return true;
 }
 
-int main() {
+/**
+ * 배치 로드 작업 하나
+ * @param objName obj 파일 이름
+ * @param loadAddress 로드 주소
+ * @param image 워커 스레드가 파싱/재배치한 결과를 담는 개별 메모리
+ */
+struct LoadJob {
+    string objName;
+    size_t loadAddress;
+    unique_ptr<Memory> image;
+};
+
+/**
+ * 로드된 영역의 인터벌 인덱스
+ * 구간을 시작 주소 순으로 훑으면서 아직 끝나지 않은 구간(끝 주소 순 multimap)과 비교하여 겹치는 쌍을 찾는다.
+ */
+class IntervalIndex {
+private:
+    struct Interval { size_t from; size_t to; string name; };
+    vector<Interval> intervals;
+
+public:
+    void add(size_t from, size_t to, const string &name) {
+        if (from < to) intervals.push_back(Interval{from, to, name});
+    }
+
+    /**
+     * 겹치는 구간 쌍 목록 반환
+     * @return (구간1 이름, 구간2 이름, 겹침 시작, 겹침 끝)
+     */
+    vector<tuple<string, string, size_t, size_t>> overlaps() {
+        vector<tuple<string, string, size_t, size_t>> out;
+        sort(intervals.begin(), intervals.end(), [](const Interval &a, const Interval &b) { return a.from < b.from; });
+        multimap<size_t, const Interval *> active; // 끝 주소 -> 구간
+        for (auto &iv : intervals) {
+            active.erase(active.begin(), active.upper_bound(iv.from)); // 이미 끝난 구간 제거
+            for (auto &p : active) out.emplace_back(p.second->name, iv.name, iv.from, min(iv.to, p.second->to));
+            active.emplace(iv.to, &iv);
+        }
+        return out;
+    }
+};
+
+/**
+ * 배치 목록 파일 읽기
+ * 한 줄에 "obj파일 로드주소(16진수)", '-'이면 표준 입력에서 읽는다.
+ */
+vector<LoadJob> readBatchList(const string &listFile) {
+    vector<LoadJob> jobs;
+    ifstream f;
+    istream *in = &cin;
+    if (listFile != "-") {
+        f.open(listFile);
+        if (!f.is_open()) {
+            cout << "cannot find batch list: " << listFile << endl;
+            return jobs;
+        }
+        in = &f;
+    }
+    string line;
+    while (getline(*in, line)) {
+        vector<string> toks = split(line);
+        if (toks.size() < 2 || toks[0][0] == '.') continue;
+        jobs.push_back(LoadJob{toks[0], hexstrToHex(toks[1]), nullptr});
+    }
+    return jobs;
+}
+
+/**
+ * 여러 obj 파일을 워커 스레드에서 각자의 메모리로 파싱/재배치한 뒤 공유 메모리에 병합
+ * 병합은 목록 순서대로 하며 (뒤의 것이 덮어씀), 겹치는 영역은 인터벌 인덱스로 찾아 보고한다.
+ * @return 겹침이 없으면 true
+ */
+bool batchLoad(vector<LoadJob> &jobs, Memory &memory) {
+    size_t workers = max(1u, thread::hardware_concurrency());
+    workers = min(workers, jobs.size());
+    atomic<size_t> next(0);
+
+    vector<thread> pool;
+    for (size_t w = 0; w < workers; w++) {
+        pool.emplace_back([&]() {
+            for (size_t i = next++; i < jobs.size(); i = next++) {
+                LoadJob &job = jobs[i];
+                job.image.reset(new Memory());
+                job.image->setLoadAddress(job.loadAddress);
+                fileRead(job.objName, *job.image);
+            }
+        });
+    }
+    for (auto &t : pool) t.join();
+
+    IntervalIndex index;
+    size_t lo = memory.getMemSize(), hi = 0;
+    for (auto &job : jobs) {
+        size_t from = job.loadAddress;
+        size_t to = min(from + job.image->getProgramLength(), memory.getMemSize());
+        if (from >= to) {
+            cout << "nothing loaded: " << job.objName << endl;
+            continue;
+        }
+        memcpy(memory.getMemPtr() + from, job.image->getMemPtr() + from, to - from);
+        index.add(from, to, job.objName);
+        if (memory.getProgramName().empty()) {
+            memory.setProgramName(job.image->getProgramName());
+            memory.setProgramStart(job.image->getProgramStart());
+        }
+        lo = min(lo, from);
+        hi = max(hi, to);
+    }
+    if (lo < hi) {
+        memory.setLoadAddress(lo);
+        memory.setProgramLength(hi - lo);
+    }
+
+    auto overlaps = index.overlaps();
+    for (auto &o : overlaps) {
+        cout << "overlap: " << get<0>(o) << " / " << get<1>(o)
+             << " [" << hexToHexstr(get<2>(o)) << ", " << hexToHexstr(get<3>(o)) << ")" << endl;
+    }
+    return overlaps.empty();
+}
+
+/**
+ * 사용법: task9-2 [-r 시작-끝] [-a] [-b 이미지파일] [-q] [-s 스냅샷파일] [-m 목록파일]
+ * -r 시작-끝: 덤프할 주소 범위 (16진수, 끝 미포함)
+ * -a: 전체 메모리 덤프
+ * -b 이미지파일: 덤프 범위를 raw 바이너리로 저장
+ * -q: cout 출력 생략 (파일에만 기록)
+ * -s 스냅샷파일: 같은 obj/로드 주소로 만든 스냅샷이 있으면 매핑해서 사용하고, 없으면 로드 후 저장
+ * -m 목록파일: "obj파일 로드주소" 목록을 병렬로 로드 (표준 입력 프롬프트 생략)
+ * 범위를 지정하지 않으면 로드된 프로그램 범위만 덤프한다.
+ */
+int main(int argc, char **argv) {
     Memory memory;
     memory.setProgramStart(0);
     string file;
     string inputStart;
-    
+
+    DumpOptions dump;
+    string range;
+    string snapshot;
+    string batchList;
+    bool all = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-r" && i + 1 < argc) range = argv[++i];
+        else if (arg == "-a") all = true;
+        else if (arg == "-b" && i + 1 < argc) dump.imageFile = argv[++i];
+        else if (arg == "-q") dump.toConsole = false;
+        else if (arg == "-s" && i + 1 < argc) snapshot = argv[++i];
+        else if (arg == "-m" && i + 1 < argc) batchList = argv[++i];
+    }
+
+    if (!batchList.empty()) {
+        vector<LoadJob> jobs = readBatchList(batchList);
+        bool ok = batchLoad(jobs, memory);
+        dump.from = all ? 0 : memory.getLoadAddress();
+        dump.to = all ? memory.getMemSize() : memory.getLoadAddress() + memory.getProgramLength();
+        if (!range.empty() && range.find('-') != string::npos) {
+            dump.from = hexstrToHex(range.substr(0, range.find('-')));
+            dump.to = hexstrToHex(range.substr(range.find('-') + 1));
+        }
+        printMemory(memory, dump);
+        return ok ? 0 : 1;
+    }
+
     cout << "objfile 이름 입력: ";
     getline(cin, file);
 
@@ -276,7 +643,23 @@ int main() {
     cin >> inputStart;
     memory.setLoadAddress(hexstrToHex(inputStart));
 
-    fileRead(file, memory);
+    if (!snapshot.empty() && loadSnapshot(memory, snapshot, file, memory.getLoadAddress())) {
+        cout << "\nsnapshot loaded: " << snapshot;
+    } else {
+        fileRead(file, memory);
+        if (!snapshot.empty() && !saveSnapshot(memory, snapshot, file)) cout << "\ncannot write snapshot: " << snapshot;
+    }
 
-    printMemory(memory);
+    if (all) {
+        dump.from = 0;
+        dump.to = memory.getMemSize();
+    } else if (!range.empty() && range.find('-') != string::npos) {
+        dump.from = hexstrToHex(range.substr(0, range.find('-')));
+        dump.to = hexstrToHex(range.substr(range.find('-') + 1));
+    } else {
+        dump.from = memory.getLoadAddress();
+        dump.to = memory.getLoadAddress() + memory.getProgramLength();
+    }
+    cout << "\n";
+    printMemory(memory, dump);
 }
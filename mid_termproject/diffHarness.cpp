@@ -0,0 +1,404 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <chrono>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+using namespace std;
+
+/**
+ * mid_termproject의 어셈블러 구현들을 같은 소스로 실행해 목적 프로그램과 실행 시간을 비교
+ * 구현마다 입력 방법(인자 / 표준 입력)과 목적 파일 이름이 달라서 표로 정리해 둔다.
+ */
+struct Variant {
+    string name;    // 소스 파일 이름 (name.cpp), 실행 파일 이름
+    string objFile; // 작성하는 목적 파일
+    bool askStdin;  // 표준 입력으로 optab 파일 이름과 소스 파일 이름을 받음
+};
+static const vector<Variant> VARIANTS = {
+    {"termProject", "OBJFILE.obj", false},
+    {"test_newnew", "OBJFILE.obj", false},
+    {"test_new", "OBJFILE.obj", true},
+    {"test_1025", "OBJFILE.obj", false},
+    {"test_1026", "OBJFILE.obj", false},
+    {"test_best", "OBJFILE", false},
+    {"test_better", "OBJFILE.txt", false},
+};
+
+// 문자열 앞뒤 공백 제거
+static inline string trim(const string &s) {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == string::npos) return "";
+    size_t b = s.find_last_not_of(" \t\r\n");
+    return s.substr(a, b - a + 1);
+}
+// 16진수 문자 하나 -> 값 (16진수 문자가 아니면 -1)
+static inline int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+// 16진수 문자열 일부 -> 값. 16진수가 아닌 문자가 있으면 ok=false
+static uint32_t hexField(const string &s, size_t pos, size_t len, bool &ok) {
+    uint32_t v = 0;
+    if (pos + len > s.size()) { ok = false; return 0; }
+    for (size_t i = pos; i < pos + len; i++) {
+        int d = hexDigit(s[i]);
+        if (d < 0) { ok = false; return 0; }
+        v = (v << 4) | (uint32_t)d;
+    }
+    return v;
+}
+static inline string hexPad(uint32_t v, int width) {
+    stringstream ss;
+    ss << uppercase << hex << setw(width) << setfill('0') << v;
+    return ss.str();
+}
+
+/**
+ * 정규화한 제어 섹션
+ * T 레코드는 주소별 바이트로 펼쳐서 레코드를 어디서 나눴는지와 상관없이 비교한다.
+ * M 레코드에서 자기 섹션 이름(+NAME)은 심볼을 생략한 것과 같게 본다.
+ */
+struct ObjSection {
+    string name;
+    uint32_t start = 0, length = 0;
+    map<uint32_t, uint8_t> bytes;
+    multiset<string> mods;       // "주소 길이 심볼"
+    set<string> defs, refs;      // D, R 레코드의 심볼
+    bool hasEntry = false;
+    uint32_t entry = 0;
+};
+
+/**
+ * 목적 파일을 읽어 섹션 목록으로 정규화
+ * @return 형식이 잘못된 줄이 있으면 false (err에 설명)
+ */
+static bool loadObject(const string &path, vector<ObjSection> &out, string &err) {
+    ifstream ifs(path);
+    if (!ifs) { err = "no output"; return false; }
+    string line;
+    int lineNo = 0;
+    while (getline(ifs, line)) {
+        ++lineNo;
+        line = trim(line);
+        if (line.empty()) continue;
+        bool ok = true;
+        char kind = (char)toupper((unsigned char)line[0]);
+        if (kind != 'H' && out.empty()) { err = "record before H at line " + to_string(lineNo); return false; }
+        if (kind == 'H') {
+            ObjSection s;
+            s.name = trim(line.substr(1, 6));
+            s.start = hexField(line, 7, 6, ok);
+            s.length = hexField(line, 13, 6, ok);
+            out.push_back(s);
+        } else if (kind == 'T') {
+            uint32_t addr = hexField(line, 1, 6, ok);
+            uint32_t len = hexField(line, 7, 2, ok);
+            for (uint32_t i = 0; ok && i < len; i++) out.back().bytes[addr + i] = (uint8_t)hexField(line, 9 + 2 * i, 2, ok);
+        } else if (kind == 'M') {
+            uint32_t addr = hexField(line, 1, 6, ok);
+            uint32_t len = hexField(line, 7, 2, ok);
+            string sym = line.size() > 9 ? trim(line.substr(9)) : "";
+            if (sym.size() > 1 && trim(sym.substr(1)) == out.back().name) sym.clear();
+            out.back().mods.insert(hexPad(addr, 6) + " " + hexPad(len, 2) + " " + sym);
+        } else if (kind == 'D') {
+            for (size_t i = 1; i + 12 <= line.size() && ok; i += 12) out.back().defs.insert(trim(line.substr(i, 6)) + "@" + hexPad(hexField(line, i + 6, 6, ok), 6));
+        } else if (kind == 'R') {
+            for (size_t i = 1; i < line.size(); i += 6) out.back().refs.insert(trim(line.substr(i, 6)));
+        } else if (kind == 'E') {
+            if (line.size() > 1) { out.back().hasEntry = true; out.back().entry = hexField(line, 1, 6, ok); }
+        } else ok = false;
+        if (!ok) { err = "bad record at line " + to_string(lineNo); return false; }
+    }
+    if (out.empty()) { err = "empty output"; return false; }
+    return true;
+}
+
+/**
+ * 기준 결과와 비교해 다른 레코드 종류를 돌려줌 ("" 이면 같음), detail에 첫 차이 설명
+ */
+static string compareObjects(const vector<ObjSection> &ref, const vector<ObjSection> &got, string &detail) {
+    if (ref.size() != got.size()) {
+        detail = to_string(got.size()) + " section(s), expected " + to_string(ref.size());
+        return "H";
+    }
+    string kinds;
+    for (size_t k = 0; k < ref.size(); k++) {
+        const ObjSection &a = ref[k], &b = got[k];
+        string where = ref.size() > 1 ? " in section " + a.name : "";
+        if (a.name != b.name || a.start != b.start || a.length != b.length) {
+            if (kinds.find('H') == string::npos) kinds += "H";
+            if (detail.empty()) detail = "H " + b.name + " " + hexPad(b.start, 6) + " " + hexPad(b.length, 6) + ", expected "
+                                      + a.name + " " + hexPad(a.start, 6) + " " + hexPad(a.length, 6) + where;
+        }
+        if (a.defs != b.defs || a.refs != b.refs) {
+            if (kinds.find('D') == string::npos) kinds += "D";
+            if (detail.empty()) detail = "D/R records differ" + where;
+        }
+        if (a.bytes != b.bytes) {
+            if (kinds.find('T') == string::npos) kinds += "T";
+            if (detail.empty()) {
+                auto ia = a.bytes.begin(), ib = b.bytes.begin();
+                while (ia != a.bytes.end() && ib != b.bytes.end() && *ia == *ib) { ++ia; ++ib; }
+                if (ia == a.bytes.end()) detail = "extra byte at " + hexPad(ib->first, 6) + where;
+                else if (ib == b.bytes.end() || ia->first < ib->first) detail = "missing byte at " + hexPad(ia->first, 6) + where;
+                else if (ib->first < ia->first) detail = "extra byte at " + hexPad(ib->first, 6) + where;
+                else detail = "byte at " + hexPad(ia->first, 6) + " is " + hexPad(ib->second, 2) + ", expected " + hexPad(ia->second, 2) + where;
+            }
+        }
+        if (a.mods != b.mods) {
+            if (kinds.find('M') == string::npos) kinds += "M";
+            if (detail.empty()) detail = to_string(b.mods.size()) + " M record(s), expected " + to_string(a.mods.size()) + where;
+        }
+        if (a.hasEntry != b.hasEntry || a.entry != b.entry) {
+            if (kinds.find('E') == string::npos) kinds += "E";
+            if (detail.empty()) detail = "entry " + (b.hasEntry ? hexPad(b.entry, 6) : string("none")) + ", expected " + (a.hasEntry ? hexPad(a.entry, 6) : string("none")) + where;
+        }
+    }
+    return kinds;
+}
+
+/**
+ * 실행 결과 한 칸
+ */
+struct Cell {
+    bool ran = false;     // 정상 종료하고 목적 파일을 남김
+    double seconds = 0;   // 반복 중 가장 짧은 실행 시간
+    string status;        // "ok", "DIFF(T)", "exit 1", "signal 11", "timeout" ...
+    string detail;
+    vector<ObjSection> obj;
+};
+
+/**
+ * 빈 작업 디렉토리에서 구현 하나를 실행
+ * 자식은 alarm으로 시간 제한을 걸고 exec하므로 끝나지 않는 구현은 SIGALRM으로 끝난다.
+ * @return 종료 상태 (waitpid 형식), fork 실패 시 -1
+ */
+static int runVariant(const Variant &v, const string &binary, const string &dir, const string &src, int timeoutSec, double &seconds) {
+    string input = "optab.txt\n" + src + "\n";
+    int ptc[2];
+    if (pipe(ptc) == -1) {
+        perror("pipe: ptc error");
+        return -1;
+    }
+    auto t0 = chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fail to fork");
+        close(ptc[0]); close(ptc[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        if (chdir(dir.c_str()) != 0) _exit(126);
+        int log = open("run.log", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log >= 0) { dup2(log, STDOUT_FILENO); dup2(log, STDERR_FILENO); close(log); }
+        dup2(ptc[0], STDIN_FILENO);
+        close(ptc[0]); close(ptc[1]);
+        signal(SIGPIPE, SIG_DFL); // harness가 무시하도록 바꾼 것을 구현에 물려주지 않음
+        alarm((unsigned)timeoutSec);
+        if (v.askStdin) execl(binary.c_str(), binary.c_str(), (char *)nullptr);
+        else execl(binary.c_str(), binary.c_str(), src.c_str(), (char *)nullptr);
+        _exit(127);
+    }
+    close(ptc[0]);
+    // 표준 입력으로 받는 구현에만 내용을 주고, 나머지는 바로 EOF
+    if (v.askStdin && write(ptc[1], input.data(), input.size()) < 0) {}
+    close(ptc[1]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return status;
+}
+
+// 실행 파일 경로를 절대 경로로 (작업 디렉토리로 chdir한 뒤에도 찾을 수 있도록)
+static string absolutePath(const string &p) {
+    char buf[PATH_MAX];
+    if (realpath(p.c_str(), buf)) return buf;
+    return p;
+}
+
+// 디렉토리 안의 파일들과 디렉토리 삭제
+static void removeDir(const string &dir) {
+    for (const char *f : {"optab.txt", "run.log", "OBJFILE.obj", "OBJFILE", "OBJFILE.txt", "INTFILE.txt", "INTFILE",
+                          "SYMTAB.txt", "LITTAB.txt"})
+        unlink((dir + "/" + f).c_str());
+    rmdir(dir.c_str());
+}
+
+static bool copyFile(const string &from, const string &to) {
+    ifstream in(from, ios::binary);
+    ofstream out(to, ios::binary);
+    if (!in || !out) return false;
+    out << in.rdbuf();
+    return true;
+}
+
+/**
+ * 사용법: diffHarness [-d 실행파일디렉토리] [-o optab.txt] [-r 반복횟수] [-t 제한초] [-R 기준구현] [-v 구현,...] [-k] 소스...
+ * -d: 구현 실행 파일이 있는 디렉토리 (기본 현재 디렉토리). 실행 파일 이름은 구현 이름과 같다.
+ *     예: for f in termProject test_*; do g++ -O2 -std=c++17 -pthread -o bin/$f $f.cpp; done
+ * -o: 작업 디렉토리마다 복사할 optab 파일 (기본 optab.txt)
+ * -r: 구현마다 반복 실행해 가장 짧은 시간을 씀 (기본 3)
+ * -t: 실행 한 번의 시간 제한 (기본 20초)
+ * -R: 정답으로 삼을 구현 (기본 termProject)
+ * -v: 비교할 구현만 콤마로 지정 (기본 전부)
+ * -k: 작업 디렉토리를 지우지 않고 남김 (차이 확인용)
+ * 목적 파일은 H/D/R/T/M/E 레코드로 정규화해 비교한다. T 레코드를 어디서 나눴는지는 차이로 보지 않는다.
+ */
+int main(int argc, char **argv) {
+    string binDir = ".", optab = "optab.txt", refName = "termProject";
+    int reps = 3, timeoutSec = 20;
+    bool keep = false;
+    set<string> only;
+    vector<string> sources;
+    // 입력을 읽기 전에 끝난 구현에 쓰다가 harness가 SIGPIPE로 죽지 않도록 (write가 EPIPE를 돌려줌)
+    signal(SIGPIPE, SIG_IGN);
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        if (a == "-d" && i + 1 < argc) binDir = argv[++i];
+        else if (a == "-o" && i + 1 < argc) optab = argv[++i];
+        else if (a == "-r" && i + 1 < argc) reps = max(1, atoi(argv[++i]));
+        else if (a == "-t" && i + 1 < argc) timeoutSec = max(1, atoi(argv[++i]));
+        else if (a == "-R" && i + 1 < argc) refName = argv[++i];
+        else if (a == "-v" && i + 1 < argc) {
+            stringstream ss(argv[++i]);
+            string name;
+            while (getline(ss, name, ',')) if (!trim(name).empty()) only.insert(trim(name));
+        }
+        else if (a == "-k") keep = true;
+        else sources.push_back(a);
+    }
+    if (sources.empty()) { cerr << "No source files\n"; return 2; }
+
+    vector<Variant> variants;
+    vector<string> binaries;
+    int refIdx = -1;
+    for (auto &v : VARIANTS) {
+        if (!only.empty() && !only.count(v.name) && v.name != refName) continue;
+        string bin = absolutePath(binDir + "/" + v.name);
+        if (access(bin.c_str(), X_OK) != 0) { cerr << "skip " << v.name << ": no executable " << bin << "\n"; continue; }
+        if (v.name == refName) refIdx = (int)variants.size();
+        variants.push_back(v);
+        binaries.push_back(bin);
+    }
+    if (variants.empty()) { cerr << "No variants to run\n"; return 2; }
+    if (refIdx < 0) cerr << "Reference " << refName << " not available: outputs are not compared\n";
+
+    // cells[소스][구현]
+    vector<vector<Cell>> cells(sources.size(), vector<Cell>(variants.size()));
+    for (size_t s = 0; s < sources.size(); s++) {
+        string src = absolutePath(sources[s]);
+        for (size_t k = 0; k < variants.size(); k++) {
+            Cell &c = cells[s][k];
+            c.seconds = 1e30;
+            string dir;
+            for (int r = 0; r < reps; r++) {
+                char tmpl[] = "/tmp/sicdiff.XXXXXX";
+                if (!mkdtemp(tmpl)) { perror("mkdtemp"); return 1; }
+                dir = tmpl;
+                if (!copyFile(optab, dir + "/optab.txt")) { cerr << "Cannot copy " << optab << "\n"; removeDir(dir); return 1; }
+                double secs = 0;
+                int status = runVariant(variants[k], binaries[k], dir, src, timeoutSec, secs);
+                if (status == -1) c.status = "fork failed";
+                else if (WIFSIGNALED(status)) c.status = WTERMSIG(status) == SIGALRM ? "timeout" : "signal " + to_string(WTERMSIG(status));
+                else if (WEXITSTATUS(status) != 0) c.status = "exit " + to_string(WEXITSTATUS(status));
+                else {
+                    c.seconds = min(c.seconds, secs);
+                    if (r == 0) {
+                        c.obj.clear();
+                        c.ran = loadObject(dir + "/" + variants[k].objFile, c.obj, c.detail);
+                        c.status = c.ran ? "ok" : "bad output";
+                    }
+                }
+                bool last = r + 1 == reps || c.status != "ok";
+                if (!(keep && last)) removeDir(dir);
+                if (c.status != "ok" && c.status != "bad output") break;
+            }
+            if (keep) cerr << sources[s] << " " << variants[k].name << ": " << dir << "\n";
+        }
+        // 기준 결과와 비교. 기준이 없거나 기준이 이 소스에서 실패하면 비교하지 못한 칸은 정답으로 세지 않는다
+        for (size_t k = 0; k < variants.size(); k++) {
+            Cell &c = cells[s][k];
+            if ((int)k == refIdx || !c.ran) continue;
+            if (refIdx < 0) c.status = "no ref";
+            else if (!cells[s][refIdx].ran) {
+                c.status = "unverified";
+                c.detail = "reference " + variants[refIdx].name + ": " + cells[s][refIdx].status;
+            } else {
+                string kinds = compareObjects(cells[s][refIdx].obj, c.obj, c.detail);
+                if (!kinds.empty()) c.status = "DIFF(" + kinds + ")";
+            }
+        }
+    }
+
+    // 표: 행은 소스, 열은 구현. 칸은 "시간 상태"
+    size_t srcWidth = 8;
+    for (auto &s : sources) srcWidth = max(srcWidth, s.size() + 2);
+    vector<size_t> width(variants.size());
+    for (size_t k = 0; k < variants.size(); k++) {
+        width[k] = variants[k].name.size() + ((int)k == refIdx ? 1 : 0) + 2;
+        for (size_t s = 0; s < sources.size(); s++) width[k] = max(width[k], (size_t)12 + cells[s][k].status.size());
+    }
+    auto cellText = [&](const Cell &c) {
+        stringstream ss;
+        if (c.seconds < 1e29) ss << fixed << setprecision(1) << c.seconds * 1000 << "ms ";
+        ss << c.status;
+        return ss.str();
+    };
+    cout << left << setw((int)srcWidth) << "source";
+    for (size_t k = 0; k < variants.size(); k++) cout << setw((int)width[k]) << variants[k].name + ((int)k == refIdx ? "*" : "");
+    cout << "\n";
+    for (size_t s = 0; s < sources.size(); s++) {
+        cout << setw((int)srcWidth) << sources[s];
+        for (size_t k = 0; k < variants.size(); k++) cout << setw((int)width[k]) << cellText(cells[s][k]);
+        cout << "\n";
+    }
+    if (refIdx >= 0) cout << "(* = reference)\n";
+
+    // 차이 설명
+    bool header = false;
+    for (size_t s = 0; s < sources.size(); s++) {
+        for (size_t k = 0; k < variants.size(); k++) {
+            const Cell &c = cells[s][k];
+            if (c.status == "ok") continue;
+            if (!header) { cout << "\nDifferences:\n"; header = true; }
+            cout << "  " << sources[s] << " / " << variants[k].name << ": " << c.status;
+            if (!c.detail.empty()) cout << " - " << c.detail;
+            cout << "\n";
+        }
+    }
+
+    // 구현별 요약: 모든 소스에서 기준과 같은 구현 중 전체 시간이 가장 짧은 것 ("unverified", "no ref"는 정답이 아님)
+    cout << "\n" << setw(14) << "variant" << right << setw(10) << "correct" << setw(14) << "total(ms)" << left << "\n";
+    int best = -1;
+    double bestTime = 1e30;
+    for (size_t k = 0; k < variants.size(); k++) {
+        int correct = 0;
+        double total = 0;
+        for (size_t s = 0; s < sources.size(); s++) {
+            if (cells[s][k].status == "ok") correct++;
+            if (cells[s][k].seconds < 1e29) total += cells[s][k].seconds;
+        }
+        cout << setw(14) << variants[k].name << right << setw(6) << correct << "/" << setw(3) << sources.size()
+             << setw(14) << fixed << setprecision(1) << total * 1000 << left << "\n";
+        if (correct == (int)sources.size() && total < bestTime) { best = (int)k; bestTime = total; }
+    }
+    if (best >= 0) cout << "fastest correct: " << variants[best].name << " (" << fixed << setprecision(1) << bestTime * 1000 << "ms)\n";
+    else cout << "fastest correct: none\n";
+    return 0;
+}
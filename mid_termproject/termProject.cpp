@@ -1,4 +1,18 @@
 #include <bits/stdc++.h>
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <dirent.h>
 using namespace std;
 
 // ---------- utilities ----------
@@ -46,6 +60,32 @@ static inline bool isNumberToken(const string &s) {
     for (; i<s.size(); ++i) if (!isdigit((unsigned char)s[i])) return false;
     return true;
 }
+/**
+ * stoul / stoll / stoi와 같은 규칙으로 변환하되 실패하면 예외 대신 false 반환
+ * (앞 공백과 부호 허용, 숫자 뒤에 오는 문자는 무시, 숫자가 없거나 범위를 넘으면 실패)
+ * 잘못된 입력이 많을 때 예외를 던지고 잡는 비용이 크므로 변환은 모두 이 함수들을 쓴다.
+ */
+static inline bool parseULong(const string &s, unsigned long &v, int base = 0) {
+    const char *b = s.c_str(); char *end = nullptr;
+    errno = 0;
+    unsigned long r = strtoul(b, &end, base);
+    if (end == b || errno == ERANGE) return false;
+    v = r; return true;
+}
+static inline bool parseLong(const string &s, long long &v) {
+    const char *b = s.c_str(); char *end = nullptr;
+    errno = 0;
+    long long r = strtoll(b, &end, 10);
+    if (end == b || errno == ERANGE) return false;
+    v = r; return true;
+}
+static inline bool parseInt(const string &s, int &v) {
+    const char *b = s.c_str(); char *end = nullptr;
+    errno = 0;
+    long r = strtol(b, &end, 10);
+    if (end == b || errno == ERANGE || r < INT_MIN || r > INT_MAX) return false;
+    v = (int)r; return true;
+}
 // 단일 문자 구분자를 기준으로 분리
 static inline vector<string> splitByChar(const string &s, char c) {
     vector<string> out; 
@@ -140,6 +180,7 @@ struct IntLine {
     uint32_t addr; // relative to block
     bool generatedObject;
     string objectCode;
+    vector<string> extRefs; // 외부 참조 수정 항목 (+SYM / -SYM)
 };
 vector<IntLine> INTLINES;
 
@@ -148,22 +189,259 @@ string programName = "      "; // 프로그램 이름
 string startBlockName = "DEFAULT";
 string END_OPERAND = ""; // END 지시어의 operand
 
+// 현재 제어 섹션의 외부 정의/참조 심볼 (선언 순서 유지)
+// EXTDEF는 미정의 에러를 보고할 수 있도록 선언된 줄 번호를 함께 둔다
+vector<pair<string,int>> EXTDEF_LIST;
+vector<string> EXTREF_LIST;
+unordered_set<string> EXTREF_SET;
+
+/**
+ * 제어 섹션(CSECT)별 상태
+ * 섹션마다 SYMTAB, 블록(LOCCTR), 리터럴, INTLINES, EXTDEF/EXTREF가 따로 유지된다.
+ * pass1/pass2는 작업할 섹션의 상태를 swapSection으로 전역 변수에 올려놓고 기존 함수들을 그대로 사용한다.
+ */
+struct CSection {
+    string name;
+    uint32_t start = 0;
+    map<string, SymEntry> symtab;
+    vector<LitEntry> lits;
+    unordered_map<string,int> litKeyToIdx;
+    unordered_map<string,string> litTokenMap;
+    vector<string> blockOrder;
+    unordered_map<string, Block> blocktab;
+    vector<IntLine> intlines;
+    vector<pair<string,int>> extdef;
+    vector<string> extref;
+    unordered_set<string> extrefSet;
+};
+vector<CSection> CSECTS;
+
+// 전역 상태와 섹션 상태를 교환 (비어 있는 섹션과 교환하면 전역 상태가 초기화됨)
+void swapSection(CSection &cs) {
+    swap(programName, cs.name); swap(programStart, cs.start);
+    swap(SYMTAB, cs.symtab);
+    swap(LIT_LIST, cs.lits); swap(LIT_KEY_TO_IDX, cs.litKeyToIdx); swap(LITERAL_TOKEN_MAP, cs.litTokenMap);
+    swap(blockOrder, cs.blockOrder); swap(BLOCKTAB, cs.blocktab);
+    swap(INTLINES, cs.intlines);
+    swap(EXTDEF_LIST, cs.extdef); swap(EXTREF_LIST, cs.extref); swap(EXTREF_SET, cs.extrefSet);
+}
+
 vector<string> ERRORS;
 void logError(int lineNo, const string &msg) { stringstream ss; ss << "Line " << lineNo << ": " << msg; ERRORS.push_back(ss.str()); }
 
+/**
+ * 출력 파일 대체 지점
+ * OUTPUT_HOOK이 설정되어 있으면 출력 파일(INTFILE.txt 등)을 디스크 대신 hook이 돌려준 스트림에 쓴다.
+ * worker pool이 결과를 공유 메모리로 넘길 때 사용하며, hook이 nullptr을 돌려주면 파일로 쓴다.
+ * closeOutput은 파일을 닫거나 hook에 해당 출력이 끝났음을 알린다.
+ */
+ostream *(*OUTPUT_HOOK)(const string &fname) = nullptr;
+void (*OUTPUT_DONE_HOOK)(ostream &os) = nullptr;
+static ostream &openOutput(const string &fname, ofstream &file) {
+    if (OUTPUT_HOOK) { ostream *os = OUTPUT_HOOK(fname); if (os) return *os; }
+    file.open(fname);
+    return file;
+}
+static void closeOutput(ostream &os, ofstream &file) {
+    if (file.is_open()) file.close();
+    else if (OUTPUT_DONE_HOOK) OUTPUT_DONE_HOOK(os);
+}
+
+// ---------- 실행 중 통계 (SIGUSR1 / SIGALRM) ----------
+/**
+ * SIGUSR1을 받거나 -P로 지정한 주기의 SIGALRM이 오면 진행 상황을 stderr에 출력
+ * handler는 플래그만 세우고, 줄 단위로 도는 루프(parse, pass1, pass2, worker pool)가 pollStats로 확인한다.
+ * worker 안에서는 cerr가 진단 메시지로 돌려져 있으므로 stderr에 직접 write한다.
+ */
+volatile sig_atomic_t STATS_REQUESTED = 0;
+struct LiveStats {
+    const char *pass = "init";
+    uint64_t lines = 0;        // 현재 단계에서 처리한 줄 수
+    uint64_t totalLines = 0;   // 현재 단계의 전체 줄 수
+    uint64_t bytes = 0;        // 지금까지 만든 목적 코드 바이트 수
+    size_t jobsDone = 0, jobsTotal = 0; // worker pool 작업 수
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    uint64_t lastLines = 0;    // 직전 출력 때의 줄 수와 시각 (구간 처리 속도 계산용)
+    chrono::steady_clock::time_point last = start;
+};
+LiveStats LIVE;
+
+// 현재 프로세스의 RSS (KB). /proc이 없으면 0
+static long currentRssKb() {
+    ifstream ifs("/proc/self/statm");
+    long pages = 0, rss = 0;
+    if (!(ifs >> pages >> rss)) return 0;
+    return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static void printLiveStats() {
+    auto now = chrono::steady_clock::now();
+    double elapsed = chrono::duration<double>(now - LIVE.start).count();
+    double interval = chrono::duration<double>(now - LIVE.last).count();
+    uint64_t delta = LIVE.lines >= LIVE.lastLines ? LIVE.lines - LIVE.lastLines : LIVE.lines;
+    stringstream ss;
+    ss << "[stats] pid=" << getpid() << " pass=" << LIVE.pass << " lines=" << LIVE.lines;
+    if (LIVE.totalLines) ss << "/" << LIVE.totalLines;
+    if (LIVE.jobsTotal) ss << " jobs=" << LIVE.jobsDone << "/" << LIVE.jobsTotal;
+    ss << " symbols=" << SYMTAB.size() << " literals=" << LIT_LIST.size() << " sections=" << CSECTS.size()
+       << " bytes=" << LIVE.bytes << fixed << setprecision(0)
+       << " lines/s=" << (interval > 0 ? delta / interval : 0)
+       << " rss=" << currentRssKb() << "KB" << setprecision(2) << " elapsed=" << elapsed << "s\n";
+    string line = ss.str();
+    if (write(STDERR_FILENO, line.data(), line.size()) < 0) {}
+    LIVE.lastLines = LIVE.lines;
+    LIVE.last = now;
+}
+static inline void pollStats() {
+    if (__builtin_expect(STATS_REQUESTED, 0)) { STATS_REQUESTED = 0; printLiveStats(); }
+}
+// 단계 시작: 이름과 전체 줄 수를 기록하고 줄 수를 초기화
+static inline void statsPhase(const char *pass, uint64_t total) {
+    LIVE.pass = pass; LIVE.lines = 0; LIVE.totalLines = total; LIVE.lastLines = 0;
+    LIVE.last = chrono::steady_clock::now();
+}
+
+static void statsSignalHandler(int) { STATS_REQUESTED = 1; }
+/**
+ * SIGUSR1 handler 설치, progressSec > 0이면 그 주기로 SIGALRM을 보내 진행 상황을 출력
+ * SA_RESTART로 설치해 파일 읽기 같은 시스템 호출이 중간에 실패하지 않게 한다.
+ */
+void installStatsSignals(int progressSec) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = statsSignalHandler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &sa, nullptr);
+    if (progressSec <= 0) return;
+    sigaction(SIGALRM, &sa, nullptr);
+    struct itimerval it;
+    it.it_interval.tv_sec = progressSec; it.it_interval.tv_usec = 0;
+    it.it_value = it.it_interval;
+    setitimer(ITIMER_REAL, &it, nullptr);
+}
+
+// ---------- 단계별 계측 (-J) ----------
+/**
+ * -J 파일을 주면 단계별 시간(steady_clock)과 카운터를 모아 어셈블이 끝날 때 JSON 한 줄로 덧붙인다.
+ * 시간은 INSTR_ENABLED일 때만 재고, 카운터는 전역 변수 증가라 항상 센다.
+ * 할당 횟수는 전역 operator new를 바꿔 세며, 이것도 INSTR_ENABLED일 때만 센다.
+ */
+bool INSTR_ENABLED = false;
+static atomic<uint64_t> ALLOC_COUNT{0}, ALLOC_BYTES{0};
+struct Instrumentation {
+    // 단계별 시간 (초)
+    double parse = 0, pass1 = 0, literalPool = 0;             // pass1에는 literalPool이 포함됨
+    double encode = 0, byteMap = 0, records = 0;
+    double writeIntfile = 0, writeSymtab = 0, writeLittab = 0, writeObjfile = 0;
+    // 카운터
+    uint64_t lines = 0;
+    uint64_t symbolLookups = 0;
+    uint64_t literalRefs = 0, literalDedupHits = 0, literalsPlaced = 0;
+    uint64_t format1 = 0, format2 = 0;
+    uint64_t format3Pc = 0, format3Base = 0, format3Direct = 0, format3Immediate = 0;
+    uint64_t format4Explicit = 0, format4Promoted = 0; // +로 지정 / 범위를 벗어나 자동 변환
+    uint64_t tRecords = 0, mRecords = 0;
+    uint64_t allocStart = 0, allocBytesStart = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+};
+Instrumentation INSTR;
+
+void *operator new(size_t n) {
+    if (INSTR_ENABLED) {
+        ALLOC_COUNT.fetch_add(1, memory_order_relaxed);
+        ALLOC_BYTES.fetch_add(n, memory_order_relaxed);
+    }
+    if (void *p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+// new가 malloc을 쓰므로 delete도 짝을 맞춰 free로 해제 (sanitizer의 alloc-dealloc 검사와 일치)
+// (인라인되면 GCC가 new 결과를 free한다고 -Wmismatched-new-delete 경고를 내므로 인라인하지 않음)
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept { free(p); }
+
+// 한 번의 어셈블을 시작할 때 호출
+void resetInstrumentation() {
+    INSTR = Instrumentation();
+    INSTR.allocStart = ALLOC_COUNT.load(memory_order_relaxed);
+    INSTR.allocBytesStart = ALLOC_BYTES.load(memory_order_relaxed);
+}
+
+/**
+ * 생성부터 stop(또는 소멸)까지의 시간을 acc에 더함. 계측이 꺼져 있으면 시계를 읽지 않는다.
+ */
+struct PhaseTimer {
+    double *acc;
+    chrono::steady_clock::time_point begin;
+    explicit PhaseTimer(double &a) : acc(INSTR_ENABLED ? &a : nullptr) {
+        if (acc) begin = chrono::steady_clock::now();
+    }
+    void stop() {
+        if (!acc) return;
+        *acc += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        acc = nullptr;
+    }
+    ~PhaseTimer() { stop(); }
+};
+
+// JSON 문자열 이스케이프
+static string jsonString(const string &s) {
+    string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if ((unsigned char)c < 0x20) { char buf[8]; snprintf(buf, sizeof(buf), "\\u%04x", c); out += buf; }
+        else out += c;
+    }
+    return out + "\"";
+}
+
+/**
+ * 계측 결과를 path에 JSON 한 줄로 덧붙임 (실행마다 한 줄)
+ * locctr는 pass1에서 리터럴 풀 처리 시간을 뺀 값
+ */
+void writeInstrumentationJson(const string &path, const string &src) {
+    double total = chrono::duration<double>(chrono::steady_clock::now() - INSTR.start).count();
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    ostringstream js;
+    js << setprecision(9);
+    js << "{\"source\":" << jsonString(src) << ",\"lines\":" << INSTR.lines << ",\"errors\":" << ERRORS.size()
+       << ",\"sections\":" << CSECTS.size()
+       << ",\"phases_sec\":{\"parse\":" << INSTR.parse << ",\"locctr\":" << INSTR.pass1 - INSTR.literalPool
+       << ",\"literal_pool\":" << INSTR.literalPool << ",\"encode\":" << INSTR.encode << ",\"byte_map\":" << INSTR.byteMap
+       << ",\"records\":" << INSTR.records << ",\"write_intfile\":" << INSTR.writeIntfile
+       << ",\"write_symtab\":" << INSTR.writeSymtab << ",\"write_littab\":" << INSTR.writeLittab
+       << ",\"write_objfile\":" << INSTR.writeObjfile << ",\"total\":" << total << "}"
+       << ",\"counters\":{\"symbol_lookups\":" << INSTR.symbolLookups << ",\"literal_refs\":" << INSTR.literalRefs
+       << ",\"literal_dedup_hits\":" << INSTR.literalDedupHits << ",\"literals_placed\":" << INSTR.literalsPlaced
+       << ",\"format1\":" << INSTR.format1 << ",\"format2\":" << INSTR.format2
+       << ",\"format3_pc\":" << INSTR.format3Pc << ",\"format3_base\":" << INSTR.format3Base
+       << ",\"format3_direct\":" << INSTR.format3Direct << ",\"format3_immediate\":" << INSTR.format3Immediate
+       << ",\"format4_explicit\":" << INSTR.format4Explicit << ",\"format4_promoted\":" << INSTR.format4Promoted
+       << ",\"t_records\":" << INSTR.tRecords << ",\"m_records\":" << INSTR.mRecords
+       << ",\"allocations\":" << ALLOC_COUNT.load(memory_order_relaxed) - INSTR.allocStart
+       << ",\"allocated_bytes\":" << ALLOC_BYTES.load(memory_order_relaxed) - INSTR.allocBytesStart
+       << ",\"peak_rss_kb\":" << ru.ru_maxrss << "}}\n";
+    ofstream ofs(path, ios::app);
+    if (!ofs) { cerr << "Cannot open " << path << "\n"; return; }
+    ofs << js.str();
+}
+
 /**
  * 소스코드를 행 단위로 읽어 IntLine 리스트를 반환 
  * 주석(.시작) / 빈 줄 -> comment=true
  * label 존재 여부 판별: label은 맨 앞에 위치 / 없으면 opcode부터 시작
  * opcode를 모두 대문자로 변환
  */
-vector<IntLine> parseSourceFile(const string &fname) {
+vector<IntLine> parseSourceStream(istream &ifs) {
+    PhaseTimer timer(INSTR.parse);
     vector<IntLine> out;
-    ifstream ifs(fname);
-    if (!ifs) { cerr << "Cannot open source file: " << fname << "\n"; return out; }
     string raw; int lineno=0;
+    statsPhase("parse", 0);
     while (getline(ifs, raw)) {
         ++lineno;
+        LIVE.lines = (uint64_t)lineno;
+        pollStats();
         string line = raw; 
         if (!line.empty() && line.back()=='\r') line.pop_back();
         IntLine rec; rec.lineNo = lineno; rec.raw = line; rec.comment=false; rec.label=""; rec.opcode=""; rec.operand="";
@@ -187,8 +465,14 @@ vector<IntLine> parseSourceFile(const string &fname) {
         }
         out.push_back(rec);
     }
+    INSTR.lines = out.size();
     return out;
 }
+vector<IntLine> parseSourceFile(const string &fname) {
+    ifstream ifs(fname);
+    if (!ifs) { cerr << "Cannot open source file: " << fname << "\n"; return {}; }
+    return parseSourceStream(ifs);
+}
 
 /**
  * C'...', X'...', 숫자 문자열 -> 바이트 배열로 변환
@@ -207,11 +491,10 @@ vector<uint8_t> bytesFromConstant(const string &operand, bool &ok) {
         for (size_t i=0;i<inner.size(); i+=2) { string hb = inner.substr(i,2); int v = hexStrToInt(hb); res.push_back((uint8_t)v); }
         ok=true; return res;
     } else {
-        try {
-            long long v = stoll(s);
-            res.push_back((v>>16)&0xFF); res.push_back((v>>8)&0xFF); res.push_back(v&0xFF);
-            ok=true; return res;
-        } catch(...) { ok=false; return res; }
+        long long v = 0;
+        if (!parseLong(s, v)) { ok=false; return res; }
+        res.push_back((v>>16)&0xFF); res.push_back((v>>8)&0xFF); res.push_back(v&0xFF);
+        ok=true; return res;
     }
 }
 // 바이트 배열을 이어붙인 문자열 반환
@@ -232,11 +515,12 @@ struct EvalResult { bool ok; uint32_t value; bool isAbsolute; string err; };
  * @param currLocctr 현재 LOCCTR
  * @param lineNo 에러 메세지에 사용
  */
-EvalResult evalExpression(const string &expr, const string &currBlock, uint32_t currLocctr, int lineNo) {
-    // +, - 기준으로 토큰(terms) 분리
+/**
+ * +, - 기준으로 표현식을 (부호, 토큰) 목록으로 분리
+ * @return 빈 토큰이 있으면 false
+ */
+bool splitExprTerms(const string &expr, vector<pair<char,string>> &terms) {
     string s = trim(expr);
-    if (s.empty()) return {false,0,false,"empty expression"};
-    vector<pair<char,string>> terms;
     size_t i=0; char sign = '+';
     while (i < s.size()) {
         while (i<s.size() && isspace((unsigned char)s[i])) ++i;
@@ -249,11 +533,20 @@ EvalResult evalExpression(const string &expr, const string &currBlock, uint32_t
         size_t j = i; 
         while (j<s.size() && s[j] != '+' && s[j] != '-') ++j;
         string token = trim(s.substr(i, j-i));
-        if (token.empty()) return {false,0,false,"bad token in expression"};
+        if (token.empty()) return false;
         terms.push_back({sign, token});
         sign = '+';
         i = j;
     }
+    return true;
+}
+
+EvalResult evalExpression(const string &expr, const string &currBlock, uint32_t currLocctr, int lineNo) {
+    // +, - 기준으로 토큰(terms) 분리
+    string s = trim(expr);
+    if (s.empty()) return {false,0,false,"empty expression"};
+    vector<pair<char,string>> terms;
+    if (!splitExprTerms(s, terms)) return {false,0,false,"bad token in expression"};
 
     // 각 토큰에 대해
     // * -> 현재 LOCCTR
@@ -269,8 +562,11 @@ EvalResult evalExpression(const string &expr, const string &currBlock, uint32_t
         if (tok == "*") {
             val = currLocctr; isAbsTerm = false; termBlock = currBlock;
         } else if (isNumberToken(tok)) {
-            try { val = (uint32_t)stoul(tok,nullptr,0); isAbsTerm = true; } catch(...) { return {false,0,false,"bad numeric: "+tok}; }
+            unsigned long u = 0;
+            if (!parseULong(tok, u)) return {false,0,false,"bad numeric: "+tok};
+            val = (uint32_t)u; isAbsTerm = true;
         } else {
+            ++INSTR.symbolLookups;
             auto it = SYMTAB.find(toUpper(tok));
             if (it == SYMTAB.end()) return {false,0,false,"Undefined symbol '" + tok + "'"};
             val = it->second.addr; isAbsTerm = it->second.isAbsolute; termBlock = it->second.block;
@@ -306,9 +602,11 @@ EvalResult evalExpression(const string &expr, const string &currBlock, uint32_t
  * LIT_LIST의 아직 배치되지 않은 리터럴 중 현재 라인보다 위에 있는 것들을 배치
  */ 
 void processLiteralPool_upToLine(uint32_t &locctr, const string &currBlock, int currentLine) {
+    PhaseTimer timer(INSTR.literalPool);
     for (size_t i=0;i<LIT_LIST.size(); ++i) {
         auto &lit = LIT_LIST[i];
         if (!lit.hasAddr && lit.firstLineEncounter <= currentLine) {
+            ++INSTR.literalsPlaced;
             lit.hasAddr = true; lit.block = currBlock; lit.addr = locctr;
             locctr += lit.length;
             IntLine r; r.lineNo = 0; r.label=""; r.opcode="=LITERAL"; r.operand = lit.firstToken;
@@ -320,15 +618,17 @@ void processLiteralPool_upToLine(uint32_t &locctr, const string &currBlock, int
 
 // ---------- PASS1 ----------
 /**
- * 1. 소스 파일 읽어 INTLINES, SYMTAB, LIT_LIST, BLOCKTAB 채움
+ * 1. 파싱된 소스로 INTLINES, SYMTAB, LIT_LIST, BLOCKTAB 채움
  * 2. 블록별 LOCCTR 계산 및 블록 길이 산출
  * 3. 리터럴 풀 처리 
  */
-void doPass1(const string &srcFile) {
+void assignPass1(const vector<IntLine> &parsed) {
+    PhaseTimer timer(INSTR.pass1);
     // 전역 초기화
     SYMTAB.clear(); LIT_LIST.clear(); LIT_KEY_TO_IDX.clear(); LITERAL_TOKEN_MAP.clear();
     INTLINES.clear(); BLOCKTAB.clear(); blockOrder.clear(); ERRORS.clear();
-    programStart = 0; programName = "      ";
+    EXTDEF_LIST.clear(); EXTREF_LIST.clear(); EXTREF_SET.clear(); CSECTS.clear();
+    programStart = 0; programName = "      "; END_OPERAND.clear();
 
     BLOCKTAB[startBlockName] = Block{startBlockName,0,0,0,true};
     blockOrder.push_back(startBlockName);
@@ -343,13 +643,27 @@ void doPass1(const string &srcFile) {
         }
     };
 
-    vector<IntLine> parsed = parseSourceFile(srcFile);
+    // 현재 섹션 마무리
+    // - 각 블록의 길이 계산
+    // - 블록 시작 주소의 절대 주소 값 계산
+    // - 섹션 상태를 CSECTS로 옮기고 전역 상태 초기화
+    auto finishSection = [&]() {
+        for (auto &bn : blockOrder) if (BLOCKTAB.find(bn) != BLOCKTAB.end()) BLOCKTAB[bn].length = BLOCKTAB[bn].locctr;
+        uint32_t curAbs = programStart;
+        for (auto &bn : blockOrder) { BLOCKTAB[bn].startAddr = curAbs; curAbs += BLOCKTAB[bn].length; }
+        CSECTS.emplace_back();
+        swapSection(CSECTS.back());
+    };
+
     int lineno=0;
+    statsPhase("pass1", parsed.size());
     // 각 소스 라인에 대해
     for (auto &pline : parsed) {
         // 기본 INTLINE 레코드 rec 생성
         // 주석이면 push_back 
         ++lineno;
+        LIVE.lines = (uint64_t)lineno;
+        pollStats();
         IntLine rec = pline; rec.block = currBlock; rec.addr = locctr; rec.generatedObject=false; rec.objectCode="";
         if (rec.comment) { INTLINES.push_back(rec); continue; }
         string op = trim(rec.opcode); string operand = trim(rec.operand);
@@ -362,7 +676,8 @@ void doPass1(const string &srcFile) {
             started = true;
             programName = rec.label.empty()? "      " : rec.label;
             uint32_t st = 0;
-            if (!operand.empty()) { try { st = (uint32_t)stoul(operand,nullptr,0); } catch(...) { st = 0; } }
+            unsigned long u = 0;
+            if (!operand.empty() && parseULong(operand, u)) st = (uint32_t)u;
             programStart = st;
             locctr = 0; BLOCKTAB[currBlock].locctr = locctr;
             rec.addr = locctr; INTLINES.push_back(rec); continue;
@@ -386,8 +701,9 @@ void doPass1(const string &srcFile) {
             if (!operand.empty()) {
                 bool ok=false; uint32_t val=0;
                 if (isNumberToken(operand)) { // operand가 숫자
-                    try { val=(uint32_t)stoul(operand,nullptr,0); ok=true; } catch(...) { ok=false; } }
+                    unsigned long u = 0; ok = parseULong(operand, u); val = (uint32_t)u; }
                 else { // operand가 심볼 또는 표현식
+                    ++INSTR.symbolLookups;
                     auto it = SYMTAB.find(toUpper(operand));
                     if (it != SYMTAB.end()) { val = it->second.addr; ok=true; }
                     else {
@@ -410,9 +726,12 @@ void doPass1(const string &srcFile) {
                     SYMTAB[toUpper(rec.label)] = SymEntry{toUpper(rec.label), locctr, currBlock, true};
                 } else {
                     if (isNumberToken(operand)) { // operand가 숫자면 -> 숫자 값으로 등록 (절대항)
-                        uint32_t v = (uint32_t)stoul(operand,nullptr,0);
+                        unsigned long u = 0;
+                        if (!parseULong(operand, u)) logError(rec.lineNo, "EQU value out of range: " + operand);
+                        uint32_t v = (uint32_t)u;
                         SYMTAB[toUpper(rec.label)] = SymEntry{toUpper(rec.label), v, currBlock, true};
                     } else {
+                        ++INSTR.symbolLookups;
                         auto it = SYMTAB.find(toUpper(operand));
                         if (it != SYMTAB.end()) { // operand가 심볼이면 -> 심볼의 값, 절대항 여부 복사
                             SYMTAB[toUpper(rec.label)] = SymEntry{toUpper(rec.label), it->second.addr, it->second.block, it->second.isAbsolute};
@@ -450,10 +769,41 @@ void doPass1(const string &srcFile) {
         // INTLINES에 추가만 함
         if (op == "BASE") { rec.addr = locctr; INTLINES.push_back(rec); continue; }
 
+        // CSECT ------------------------
+        // 아직 배치되지 않은 리터럴을 현재 섹션에 배치하고 섹션 마무리
+        // label을 이름으로 하는 새 섹션 시작 (SYMTAB, 블록, LOCCTR 모두 새로 시작)
+        if (op == "CSECT") {
+            processLiteralPool_upToLine(locctr, currBlock, rec.lineNo);
+            BLOCKTAB[currBlock].locctr = locctr;
+            finishSection();
+
+            if (rec.label.empty()) logError(rec.lineNo, "CSECT without label");
+            programName = rec.label.empty()? "      " : rec.label;
+            programStart = 0;
+            BLOCKTAB[startBlockName] = Block{startBlockName,0,0,0,true};
+            blockOrder.push_back(startBlockName);
+            currBlock = startBlockName; locctr = 0;
+            rec.block = currBlock; rec.addr = locctr; INTLINES.push_back(rec); continue;
+        }
+
+        // EXTDEF / EXTREF ------------------------
+        // 콤마로 구분된 심볼 목록을 현재 섹션에 등록
+        if (op == "EXTDEF" || op == "EXTREF") {
+            for (auto &part : splitByChar(operand, ',')) {
+                string sym = toUpper(trim(part));
+                if (sym.empty()) continue;
+                if (op == "EXTDEF") EXTDEF_LIST.push_back({sym, rec.lineNo});
+                else if (EXTREF_SET.insert(sym).second) EXTREF_LIST.push_back(sym);
+            }
+            rec.addr = locctr; INTLINES.push_back(rec); continue;
+        }
+
         /** -------------------------------------------- label 처리 -------------------------------------------- */
         if (!rec.label.empty()) { // 레이블이 있다면 SYMTAB에 추가
             string lab = toUpper(rec.label);
+            ++INSTR.symbolLookups;
             if (SYMTAB.find(lab) != SYMTAB.end()) logError(rec.lineNo, "Duplicate symbol: " + lab);
+            else if (EXTREF_SET.count(lab)) logError(rec.lineNo, "Symbol declared in EXTREF: " + lab);
             else SYMTAB[lab] = SymEntry{lab, locctr, currBlock, false};
         }
 
@@ -468,13 +818,14 @@ void doPass1(const string &srcFile) {
                 // 16진수 값(hexKey) 생성
                 // 동일 hexKey가 있으면 firstLineEncounter 업데이트 (더 작은 라인번호 유지)
                 //               없으면 새 LitEntry 추가
+                ++INSTR.literalRefs;
                 string litToken = opnd;
                 string litVal = litToken.substr(1);
                 bool ok=false; 
                 vector<uint8_t> bytes = bytesFromConstant(litVal, ok);
                 
                 if (!ok) {
-                    vector<uint8_t> b; long long v=0; try { v = stoll(litVal); } catch(...) { v=0; }
+                    vector<uint8_t> b; long long v=0; if (!parseLong(litVal, v)) v=0;
                     b.push_back((v>>16)&0xFF); b.push_back((v>>8)&0xFF); b.push_back(v&0xFF); bytes = b; ok=true;
                 }
                 string hk = bytesToHexKey(bytes);
@@ -484,6 +835,7 @@ void doPass1(const string &srcFile) {
                     ent.hasAddr = false; ent.block=""; ent.addr=0; ent.firstLineEncounter = rec.lineNo;
                     LIT_LIST.push_back(ent); LIT_KEY_TO_IDX[hk] = (int)LIT_LIST.size()-1;
                 } else {
+                    ++INSTR.literalDedupHits;
                     int idx = LIT_KEY_TO_IDX[hk];
                     if (LIT_LIST[idx].firstLineEncounter > rec.lineNo) LIT_LIST[idx].firstLineEncounter = rec.lineNo;
                 }
@@ -508,8 +860,8 @@ void doPass1(const string &srcFile) {
         } else {
             // 어셈블러 지시자에 따른 LOCCTR 증분 결정
             if (op == "WORD") inc = 3;
-            else if (op == "RESW") { try { int n = stoi(operand); inc = 3U * (uint32_t)n; } catch(...) { inc=0; logError(rec.lineNo,"Invalid RESW"); } }
-            else if (op == "RESB") { try { int n = stoi(operand); inc = (uint32_t)n; } catch(...) { inc=0; logError(rec.lineNo,"Invalid RESB"); } }
+            else if (op == "RESW") { int n = 0; if (parseInt(operand, n)) inc = 3U * (uint32_t)n; else { inc=0; logError(rec.lineNo,"Invalid RESW"); } }
+            else if (op == "RESB") { int n = 0; if (parseInt(operand, n)) inc = (uint32_t)n; else { inc=0; logError(rec.lineNo,"Invalid RESB"); } }
             else if (op == "BYTE") {
                 if (operand.size()>=3 && (operand[0]=='C'||operand[0]=='c') && operand[1]=='\'' && operand.back()=='\'') { string inner = operand.substr(2, operand.size()-3); inc = (uint32_t)inner.size(); }
                 else if (operand.size()>=3 && (operand[0]=='X'||operand[0]=='x') && operand[1]=='\'' && operand.back()=='\'') { string inner = operand.substr(2, operand.size()-3); inc = (uint32_t)(inner.size()/2); }
@@ -523,42 +875,73 @@ void doPass1(const string &srcFile) {
         BLOCKTAB[currBlock].locctr = locctr;
     }
 
-    // 루프 종료 후
-    // - 각 블록의 길이 계산
-    // - 블록 시작 주소의 절대 주소 값 계산
-    for (auto &bn : blockOrder) if (BLOCKTAB.find(bn) != BLOCKTAB.end()) BLOCKTAB[bn].length = BLOCKTAB[bn].locctr;
-    uint32_t curAbs = programStart;
-    for (auto &bn : blockOrder) { BLOCKTAB[bn].startAddr = curAbs; curAbs += BLOCKTAB[bn].length; }
+    // 루프 종료 후 마지막 섹션 마무리
+    finishSection();
+}
+
+/**
+ * pass1 결과 파일 (INTFILE.txt, SYMTAB.txt, LITTAB.txt) 작성
+ */
+void writePass1Files() {
+    // 출력 파일은 하나씩 차례로 작성 (섹션마다 상태를 올려놓고 fn 수행)
+    auto forEachSection = [&](const function<void()> &fn) {
+        for (auto &cs : CSECTS) { swapSection(cs); fn(); swapSection(cs); }
+    };
 
     // INTFILE.txt 작성
-    ofstream intf("INTFILE.txt");
-    for (auto &r : INTLINES) {
-        if (r.comment) { intf << setw(4) << r.lineNo << "    " << r.raw << "\n"; continue; }
-        uint32_t absAddr = 0;
-        if (toUpper(r.opcode) == "START") absAddr = programStart;
-        else if (BLOCKTAB.find(r.block) != BLOCKTAB.end()) absAddr = BLOCKTAB[r.block].startAddr + r.addr;
-        else absAddr = r.addr;
-        intf << setw(4) << (r.lineNo>0? r.lineNo:0) << " " << setw(6) << hexPad(absAddr,6) << " [" << r.block << "] ";
-        if (!r.label.empty()) intf << setw(8) << r.label << " "; else intf << setw(8) << " " << " ";
-        intf << setw(8) << r.opcode; if (!r.operand.empty()) intf << " " << r.operand; intf << "\n";
-    }
-    intf.close();
-
-    // SYMTAB.txt 작성
-    ofstream symf("SYMTAB.txt");
-    for (auto &p : SYMTAB) symf << p.first << " " << hexPad(p.second.addr,6) << " " << p.second.block << (p.second.isAbsolute?" ABS":"") << "\n";
-    symf.close();
+    PhaseTimer intTimer(INSTR.writeIntfile);
+    ofstream intFile;
+    ostream &intf = openOutput("INTFILE.txt", intFile);
+    forEachSection([&]() {
+        for (auto &r : INTLINES) {
+            if (r.comment) { intf << setw(4) << r.lineNo << "    " << r.raw << "\n"; continue; }
+            uint32_t absAddr = 0;
+            if (toUpper(r.opcode) == "START") absAddr = programStart;
+            else if (BLOCKTAB.find(r.block) != BLOCKTAB.end()) absAddr = BLOCKTAB[r.block].startAddr + r.addr;
+            else absAddr = r.addr;
+            intf << setw(4) << (r.lineNo>0? r.lineNo:0) << " " << setw(6) << hexPad(absAddr,6) << " [" << r.block << "] ";
+            if (!r.label.empty()) intf << setw(8) << r.label << " "; else intf << setw(8) << " " << " ";
+            intf << setw(8) << r.opcode; if (!r.operand.empty()) intf << " " << r.operand; intf << "\n";
+        }
+    });
+    closeOutput(intf, intFile);
+    intTimer.stop();
+
+    // SYMTAB.txt 작성 (섹션이 여러 개면 섹션 이름을 머리에 표시)
+    PhaseTimer symTimer(INSTR.writeSymtab);
+    ofstream symFile;
+    ostream &symf = openOutput("SYMTAB.txt", symFile);
+    forEachSection([&]() {
+        if (CSECTS.size() > 1) symf << "CSECT " << programName << "\n";
+        for (auto &p : SYMTAB) symf << p.first << " " << hexPad(p.second.addr,6) << " " << p.second.block << (p.second.isAbsolute?" ABS":"") << "\n";
+    });
+    closeOutput(symf, symFile);
+    symTimer.stop();
 
     // LITTAB.txt 작성
-    ofstream litf("LITTAB.txt");
-    for (size_t i=0;i<LIT_LIST.size(); ++i) {
-        auto &le = LIT_LIST[i];
-        litf << i << " " << le.hexKey << " token=" << le.firstToken << " len=" << le.length << " addr=" << (le.hasAddr?hexPad(le.addr,6):string("UNDEF")) << " block=" << le.block << " firstLine=" << le.firstLineEncounter << "\n";
-    }
-    litf.close();
+    PhaseTimer litTimer(INSTR.writeLittab);
+    ofstream litFile;
+    ostream &litf = openOutput("LITTAB.txt", litFile);
+    forEachSection([&]() {
+        for (size_t i=0;i<LIT_LIST.size(); ++i) {
+            auto &le = LIT_LIST[i];
+            litf << i << " " << le.hexKey << " token=" << le.firstToken << " len=" << le.length << " addr=" << (le.hasAddr?hexPad(le.addr,6):string("UNDEF")) << " block=" << le.block << " firstLine=" << le.firstLineEncounter << "\n";
+        }
+    });
+    closeOutput(litf, litFile);
+    litTimer.stop();
 
     cout << "=== PASS1 complete ===\n";
-    cout << "Program start: " << hexPad(programStart,6) << " Name: " << programName << "\n";
+    cout << "Program start: " << hexPad(CSECTS.front().start,6) << " Name: " << CSECTS.front().name << "\n";
+    if (CSECTS.size() > 1) cout << "Control sections: " << CSECTS.size() << "\n";
+}
+
+/**
+ * 소스 파일을 읽어 pass1을 수행하고 결과 파일 작성
+ */
+void doPass1(const string &srcFile) {
+    assignPass1(parseSourceFile(srcFile));
+    writePass1Files();
 }
 
 // ---------- PASS2 helpers ----------
@@ -567,6 +950,7 @@ void doPass1(const string &srcFile) {
  */
 uint32_t computeAbsAddrSymbol(const string &sym, bool &ok) {
     ok = false;
+    ++INSTR.symbolLookups;
     auto it = SYMTAB.find(toUpper(sym));
     if (it != SYMTAB.end()) { // SYMTAB에 심볼이 있으면,
         // 블록 시작 주소 + addr한 절대 주소 반환
@@ -575,7 +959,9 @@ uint32_t computeAbsAddrSymbol(const string &sym, bool &ok) {
         if (it->second.isAbsolute) return it->second.addr;
         return BLOCKTAB[it->second.block].startAddr + it->second.addr;
     }
-    try { uint32_t v = (uint32_t)stoul(sym,nullptr,0); ok=true; return v; } catch(...) { ok=false; return 0; }
+    unsigned long u = 0;
+    ok = parseULong(sym, u);
+    return ok ? (uint32_t)u : 0;
 }
 /** Format별 object code 문자열 조립 메서드들 */
 string buildFormat1(uint8_t opcode) {
@@ -619,14 +1005,22 @@ vector<uint8_t> hexStrToBytes(const string &hexs) {
     return out;
 }
 
+// 심볼 이름을 6자리 고정 폭으로 (길면 자르고 짧으면 공백 패딩)
+static inline string padName(const string &name) {
+    return name.size() > 6 ? name.substr(0,6) : name + string(6 - name.size(), ' ');
+}
+
 // ---------- PASS2 ----------
 /**
+ * 현재 전역 상태에 올라온 제어 섹션 하나에 대해
  * INTLINES, SYMTAB, LIT_LIST, BLOCKTAB을 사용하여
  * 1. 각 라인별 object code 생성
- * 2. M 레코드 생성
- * 3. OBJFILE 생성
+ * 2. M 레코드 생성 (외부 참조는 +SYM/-SYM)
+ * 3. H/D/R/T/M/E 레코드를 records 뒤에 덧붙임
+ * @param isFirst 첫 섹션 여부. END의 진입점은 첫 섹션에만 기록
+ * @return 섹션 길이
  */
-void doPass2(const string &srcFile) {
+uint32_t assembleSection(string &records, bool isFirst) {
     // 초기화
     uint32_t curAddr = programStart;
     for (auto &bn : blockOrder) {
@@ -661,7 +1055,11 @@ void doPass2(const string &srcFile) {
     };
 
     // INTLINES 순회 -> object code 생성
+    statsPhase("pass2", INTLINES.size());
+    PhaseTimer encodeTimer(INSTR.encode);
     for (auto &r : INTLINES) {
+        ++LIVE.lines;
+        pollStats();
         r.generatedObject = false; r.objectCode = "";
         
         // 주석 및 START, END, LTORG, USE, ORG, EQU, RESW, RESB는 스킵 -> object code 생성 X
@@ -670,6 +1068,7 @@ void doPass2(const string &srcFile) {
         string operand = trim(r.operand);
 
         if (op=="START" || op=="END" || op=="LTORG" || op=="USE" || op=="ORG" || op=="EQU" || op == "RESW" || op == "RESB") continue;
+        if (op=="CSECT" || op=="EXTDEF" || op=="EXTREF") continue;
 
         // BASE --------------------------------
         // operand 있으면 base 설정
@@ -700,8 +1099,28 @@ void doPass2(const string &srcFile) {
         // 3바이트 (6자리로) 저장
         if (op == "WORD") {
             uint32_t v=0;
-            if (!operand.empty()) {
-                if (isNumberToken(operand)) v=(uint32_t)stoul(operand,nullptr,0);
+            vector<pair<char,string>> terms;
+            bool hasExternal = false;
+            if (!operand.empty() && !isNumberToken(operand) && splitExprTerms(operand, terms)) {
+                for (auto &t : terms) if (EXTREF_SET.count(toUpper(t.second))) hasExternal = true;
+            }
+            if (hasExternal) {
+                // 외부 참조 항은 0으로 두고 M 레코드로 로더에 넘김
+                long long acc = 0;
+                for (auto &t : terms) {
+                    string sym = toUpper(t.second);
+                    if (EXTREF_SET.count(sym)) { r.extRefs.push_back(string(1, t.first) + sym); continue; }
+                    bool ok=false; uint32_t a = computeAbsAddrSymbol(t.second, ok);
+                    if (!ok) { logError(r.lineNo,"WORD unresolved: "+t.second); continue; }
+                    if (t.first == '+') acc += a; else acc -= a;
+                }
+                v = (uint32_t)acc;
+            } else if (!operand.empty()) {
+                if (isNumberToken(operand)) {
+                    unsigned long u = 0;
+                    if (parseULong(operand, u)) v=(uint32_t)u;
+                    else logError(r.lineNo,"WORD value out of range: "+operand);
+                }
                 else { 
                     bool ok=false; uint32_t a = computeAbsAddrSymbol(operand, ok); 
                     if (ok) v=a; 
@@ -727,8 +1146,9 @@ void doPass2(const string &srcFile) {
                 string inner = operand.substr(2, operand.size()-3);
                 r.objectCode = toUpper(inner); r.generatedObject=true;
             } else {
-                try { uint32_t v=(uint32_t)stoul(operand,nullptr,0); r.objectCode = hexPad(v,2); r.generatedObject=true; }
-                catch(...) { logError(r.lineNo,"BYTE parse fail: "+operand); }
+                unsigned long u = 0;
+                if (parseULong(operand, u)) { r.objectCode = hexPad((uint32_t)u,2); r.generatedObject=true; }
+                else logError(r.lineNo,"BYTE parse fail: "+operand);
             }
             continue;
         }
@@ -745,6 +1165,7 @@ void doPass2(const string &srcFile) {
 
         // Format1 명령어
         if (FORMAT1.find(opClean) != FORMAT1.end()) { 
+            ++INSTR.format1;
             r.objectCode = buildFormat1(opcode); r.generatedObject=true; 
             continue; 
         }
@@ -756,14 +1177,15 @@ void doPass2(const string &srcFile) {
                 if (parts.size()>=1) { 
                     string p1 = trim(parts[0]); 
                     if (REGNUM.find(toUpper(p1)) != REGNUM.end()) r1 = REGNUM[toUpper(p1)]; 
-                    else { try { r1 = stoi(p1);} catch(...) { r1=0; } } 
+                    else if (!parseInt(p1, r1)) r1 = 0;
                 }
                 if (parts.size()>=2) { 
                     string p2 = trim(parts[1]); 
                     if (REGNUM.find(toUpper(p2)) != REGNUM.end()) r2 = REGNUM[toUpper(p2)]; 
-                    else { try { r2 = stoi(p2);} catch(...) { r2=0; } } 
+                    else if (!parseInt(p2, r2)) r2 = 0;
                 }
             }
+            ++INSTR.format2;
             r.objectCode = buildFormat2(opcode, r1, r2); r.generatedObject=true; continue;
         }
 
@@ -790,15 +1212,18 @@ void doPass2(const string &srcFile) {
 
         // e bit 설정
         if (isFormat4) e = true;
+        bool explicitFormat4 = isFormat4; // 계측: +로 지정한 Format 4와 자동 변환을 구분
 
         // disp가 12비트를 초과하면 자동으로 Format4 변환하여 e=true로 설정
         bool immediateNumeric = false; uint32_t immediateValue = 0;
         if (i && !operNoIndex.empty() && isNumberToken(operNoIndex)) {
-            try { immediateValue = (uint32_t)stoul(operNoIndex,nullptr,0); immediateNumeric=true; } 
-            catch(...) { immediateNumeric=false; }
+            unsigned long u = 0;
+            immediateNumeric = parseULong(operNoIndex, u);
+            immediateValue = (uint32_t)u;
         }
         if (immediateNumeric && !operNoIndex.empty()) {
             if (!isFormat4 && immediateValue > 0xFFF) { isFormat4 = true; e = true; }
+            ++(explicitFormat4 ? INSTR.format4Explicit : isFormat4 ? INSTR.format4Promoted : INSTR.format3Immediate);
             r.objectCode = buildFormat34(opcode, n,i,x,false,false,e, immediateValue);
             r.generatedObject=true; continue;
         }
@@ -815,8 +1240,15 @@ void doPass2(const string &srcFile) {
                 if (LIT_LIST[idx].hasAddr) { targetAbs = BLOCKTAB[LIT_LIST[idx].block].startAddr + LIT_LIST[idx].addr; okTarget=true; }
                 else { logError(r.lineNo, "Literal not placed yet: " + litTok); okTarget=false; }
             } else { logError(r.lineNo, "Literal token unknown: " + litTok); okTarget=false; }
+        } else if (!operNoIndex.empty() && EXTREF_SET.count(toUpper(operNoIndex))) {
+            // 외부 참조: 주소 필드는 0으로 두고 로더가 M 레코드로 채움 (Format 4만 가능)
+            if (!isFormat4) logError(r.lineNo, "External reference requires format 4: " + operNoIndex);
+            r.objectCode = buildFormat34(opcode, n, i, x, false, false, isFormat4, 0);
+            if (isFormat4) { r.extRefs.push_back("+" + toUpper(operNoIndex)); ++INSTR.format4Explicit; }
+            r.generatedObject = true; continue;
         } else if (!operNoIndex.empty()) {
             // SYMTAB 조회해서 절대항 여부 확인
+            ++INSTR.symbolLookups;
             auto it = SYMTAB.find(toUpper(operNoIndex));
             if (it != SYMTAB.end()) {
                 if (it->second.isAbsolute) { targetIsAbsoluteSymbol = true; targetAbs = it->second.addr; okTarget=true; }
@@ -831,6 +1263,7 @@ void doPass2(const string &srcFile) {
         // RSUB 사용하고 operand 비어 있으면 -> n=1, i=1로 0x4F0000 같은 형식으로 생성
         if (!okTarget && !(opClean == "RSUB")) { logError(r.lineNo, "Undefined operand: " + operNoIndex); continue; }
         if (opClean == "RSUB") {
+            ++INSTR.format3Direct;
             r.objectCode = buildFormat34(opcode, true, true, false, false, false, false, 0);
             r.generatedObject=true; continue;
         }
@@ -841,6 +1274,7 @@ void doPass2(const string &srcFile) {
 
         if (!isFormat4 && okTarget && !operandIsLiteral && (!immediateNumeric) && targetIsAbsoluteSymbol) {
             if (targetAbs <= 0xFFF) {
+                ++INSTR.format3Direct;
                 p = false; b = false;
                 r.objectCode = buildFormat34(opcode, n, i, x, b, p, false, targetAbs);
                 r.generatedObject = true;
@@ -855,6 +1289,7 @@ void doPass2(const string &srcFile) {
             // 우선적으로 PC-relative 시도
             int32_t disp = (int32_t)targetAbs - (int32_t)(instrAbs + 3);
             if (disp >= -2048 && disp <= 2047) {
+                ++INSTR.format3Pc;
                 p = true; b = false;
                 uint32_t disp12 = (uint32_t)(disp & 0xFFF);
                 r.objectCode = buildFormat34(opcode, n, i, x, b, p, false, disp12);
@@ -863,6 +1298,7 @@ void doPass2(const string &srcFile) {
                 if (baseOn) { // baseOn 켜져 있는지 확인하고 Base-relative 시도
                     int32_t dispb = (int32_t)targetAbs - (int32_t)baseValue;
                     if (dispb >= 0 && dispb <= 4095) {
+                        ++INSTR.format3Base;
                         b = true; p = false;
                         uint32_t disp12 = (uint32_t)(dispb & 0xFFF);
                         r.objectCode = buildFormat34(opcode, n, i, x, b, p, false, disp12);
@@ -877,43 +1313,68 @@ void doPass2(const string &srcFile) {
         }
 
         if (isFormat4) { // Format 4이면 그에 맞는 형식으로 object code 생성
+            ++(explicitFormat4 ? INSTR.format4Explicit : INSTR.format4Promoted);
             r.objectCode = buildFormat34(opcode, n, i, x, false, false, true, targetAbs);
             r.generatedObject = true; continue; // object code 생성 여부 저장
         }
     }
 
+    encodeTimer.stop();
+
     // 블록 바이트 맵 생성
     // 블록 별로 메모리 주소와 그 주소에 들어 있는 바이트를 모두 저장한 맵
+    PhaseTimer mapTimer(INSTR.byteMap);
     unordered_map<string, map<uint32_t,uint8_t>> blockByteMap;
-    vector<pair<uint32_t,int>> MRECS;
+    vector<tuple<uint32_t,int,string>> MRECS; // (주소, 하프 바이트 수, 외부 심볼)
 
     for (auto &r : INTLINES) {
         if (r.generatedObject && !r.objectCode.empty()) {
             uint32_t abs = BLOCKTAB[r.block].startAddr + r.addr;
             auto bytes = hexStrToBytes(r.objectCode);
             appendBytesToBlockMap(blockByteMap, r.block, abs, bytes, r.lineNo);
-            // Format 4인 경우
+            LIVE.bytes += bytes.size();
+            // 외부 참조가 있으면 심볼 기반 M 레코드 (WORD는 6 하프 바이트 전체)
+            // 없고 Format 4인 경우
             // 해당 명령의 절대 주소를 기준으로
             // M 레코드 작성
-            if (r.objectCode.size() == 8) {
-                MRECS.push_back({abs+1, 5});
+            if (!r.extRefs.empty()) {
+                bool isWord = toUpper(r.opcode) == "WORD";
+                for (auto &ref : r.extRefs) MRECS.push_back({isWord? abs : abs+1, isWord? 6 : 5, ref});
+            } else if (r.objectCode.size() == 8) {
+                MRECS.push_back({abs+1, 5, ""});
             }
         }
     }
 
-    // 리터럴 바이트들도 블록 바이트 맵에 추가
-    for (size_t i=0;i<LIT_LIST.size(); ++i) {
-        auto &lit = LIT_LIST[i];
-        if (!lit.hasAddr) continue;
-        uint32_t abs = BLOCKTAB[lit.block].startAddr + lit.addr;
-        appendBytesToBlockMap(blockByteMap, lit.block, abs, lit.bytes, 0);
-    }
+    // 리터럴 바이트는 LTORG/END에서 추가된 =LITERAL 줄로 이미 들어가 있음
+    mapTimer.stop();
+    PhaseTimer recordTimer(INSTR.records);
 
     // OBJFILE 생성
-    ofstream objf("OBJFILE.obj");
-    string pname = programName; if (pname.size() > 6) pname = pname.substr(0,6); else pname += string(6 - pname.size(), ' ');
-    objf << "H" << pname << hexPad(programStart,6) << hexPad(programLength,6) << "\n";
-    cout << "H" << pname << hexPad(programStart,6) << hexPad(programLength,6) << "\n";
+    string pname = padName(programName);
+    records += "H" + pname + hexPad(programStart,6) + hexPad(programLength,6) + "\n";
+
+    // D 레코드: EXTDEF 심볼과 절대 주소 (한 줄에 6개까지)
+    string drec;
+    int dcount = 0;
+    for (auto &def : EXTDEF_LIST) {
+        const string &sym = def.first;
+        bool ok=false; uint32_t a = 0;
+        if (SYMTAB.find(sym) != SYMTAB.end()) a = computeAbsAddrSymbol(sym, ok);
+        if (!ok) { logError(def.second, "EXTDEF symbol undefined: " + sym); continue; }
+        drec += padName(sym) + hexPad(a,6);
+        if (++dcount == 6) { records += "D" + drec + "\n"; drec.clear(); dcount = 0; }
+    }
+    if (!drec.empty()) records += "D" + drec + "\n";
+
+    // R 레코드: EXTREF 심볼 (한 줄에 12개까지)
+    string rrec;
+    int rcount = 0;
+    for (auto &sym : EXTREF_LIST) {
+        rrec += padName(sym);
+        if (++rcount == 12) { records += "R" + rrec + "\n"; rrec.clear(); rcount = 0; }
+    }
+    if (!rrec.empty()) records += "R" + rrec + "\n";
 
     for (auto &bn : blockOrder) {
         auto itmap = blockByteMap.find(bn);
@@ -932,29 +1393,66 @@ void doPass2(const string &srcFile) {
             stringstream ss;
             for (auto b : buf) ss<<uppercase<<hex<<setw(2)<<setfill('0')<<(int)b;
             string hexs = ss.str();
-            objf << "T" << hexPad(startAddr,6) << hexPad((uint32_t)buf.size(),2) << hexs << "\n";
-            cout << "T" << hexPad(startAddr,6) << hexPad((uint32_t)buf.size(),2) << hexs << "\n";
+            ++INSTR.tRecords;
+            records += "T" + hexPad(startAddr,6) + hexPad((uint32_t)buf.size(),2) + hexs + "\n";
         }
     }
 
+    INSTR.mRecords += MRECS.size();
     for (auto &m : MRECS) {
-        objf << "M" << hexPad(m.first,6) << hexPad(m.second,2) << "\n";
-        cout << "M" << hexPad(m.first,6) << hexPad(m.second,2) << "\n";
+        records += "M" + hexPad(get<0>(m),6) + hexPad(get<1>(m),2) + get<2>(m) + "\n";
     }
 
+    // 진입점은 첫 섹션의 E 레코드에만 기록
+    if (!isFirst) {
+        records += "E\n";
+        return programLength;
+    }
     uint32_t entryAddr = programStart;
     if (!END_OPERAND.empty()) {
         bool ok=false; uint32_t a = computeAbsAddrSymbol(END_OPERAND, ok);
         if (ok) entryAddr = a;
         else logError(0, "END entry symbol unresolved: " + END_OPERAND);
     }
-    objf << "E" << hexPad(entryAddr,6) << "\n";
-    cout << "E" << hexPad(entryAddr,6) << "\n";
+    records += "E" + hexPad(entryAddr,6) + "\n";
+    return programLength;
+}
 
-    objf.close();
+string OBJ_RECORDS; // pass2가 만든 H~E 레코드 (모든 섹션)
+vector<pair<string,uint32_t>> SECTION_LENGTHS; // 섹션 이름과 H 레코드의 길이
+
+/**
+ * 제어 섹션마다 assembleSection을 호출하여 OBJ_RECORDS 생성
+ */
+void encodePass2() {
+    OBJ_RECORDS.clear();
+    SECTION_LENGTHS.clear();
+    for (size_t k = 0; k < CSECTS.size(); ++k) {
+        swapSection(CSECTS[k]);
+        SECTION_LENGTHS.push_back({trim(programName), assembleSection(OBJ_RECORDS, k == 0)});
+        swapSection(CSECTS[k]);
+    }
+}
+
+/**
+ * OBJFILE.obj 작성 (레코드는 화면에도 출력)
+ */
+void writePass2Files() {
+    PhaseTimer objTimer(INSTR.writeObjfile);
+    ofstream objFile;
+    ostream &objf = openOutput("OBJFILE.obj", objFile);
+    objf << OBJ_RECORDS;
+    closeOutput(objf, objFile);
+    cout << OBJ_RECORDS;
+    objTimer.stop();
 
     cout << "=== PASS2 complete ===\n";
-    cout << "Program length: " << hexPad(programLength,6) << "\n";
+    // 제어 섹션마다 H 레코드에 적힌 길이를 출력
+    for (auto &sl : SECTION_LENGTHS) {
+        cout << "Program length";
+        if (SECTION_LENGTHS.size() > 1) cout << " (" << sl.first << ")";
+        cout << ": " << hexPad(sl.second,6) << "\n";
+    }
     if (!ERRORS.empty()) {
         cout << "Errors/Warnings:\n";
         for (auto &e : ERRORS) cout << e << "\n";
@@ -962,14 +1460,1179 @@ void doPass2(const string &srcFile) {
     cout << "Wrote OBJFILE.obj, INTFILE.txt, SYMTAB.txt, LITTAB.txt\n";
 }
 
+void doPass2(const string &srcFile) {
+    encodePass2();
+    writePass2Files();
+}
+
+// ---------- worker pool ----------
+/**
+ * 여러 소스 파일을 미리 fork해 둔 worker 프로세스들에 나누어 어셈블
+ * worker는 OPTAB이 적재된 뒤 fork되므로 optab.txt를 다시 읽지 않는다.
+ * 작업마다 doPass1이 전역 상태를 초기화하고, 작업은 각자의 프로세스에서 돌기 때문에
+ * 한 소스에서 비정상 종료가 나도 해당 작업만 실패로 기록되고 나머지는 계속 진행된다.
+ *
+ * parent -> child (ptc): [길이][소스 경로][길이][출력 디렉토리][소스 내용 포함 여부 1바이트]([길이][소스 내용])
+ *   소스 내용을 함께 보내면 worker는 파일을 다시 읽지 않고 그 내용을 어셈블한다 (daemon).
+ * child -> parent (ctp): JobReply 뒤에 진단 메시지 텍스트
+ * -m을 주면 출력 파일과 진단 메시지는 공유 메모리(ResultArena)로 넘기고, ctp에는 JobReply만 보낸다.
+ */
+struct FarmJob { string src; string outDir; };
+// status: 0 성공, 1 어셈블 오류 있음, 2 소스/출력 디렉토리 접근 실패
+// offset, length: 공유 메모리 모드에서 이 작업의 레코드가 놓인 범위
+struct JobReply { int32_t status; uint32_t errCount; uint32_t textLen; uint32_t reserved; uint64_t offset; uint64_t length; };
+struct ResultArena;
+// job: 처리 중인 작업 번호 (-1이면 대기 중), arena: 공유 메모리 모드가 아니면 nullptr
+struct FarmWorker { pid_t pid; int ptc; int ctp; int job; ResultArena *arena; };
+
+static bool readFull(int fd, void *buf, size_t n) {
+    char *p = (char*)buf;
+    while (n > 0) {
+        ssize_t r = read(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r; n -= (size_t)r;
+    }
+    return true;
+}
+static bool writeFull(int fd, const void *buf, size_t n) {
+    const char *p = (const char*)buf;
+    while (n > 0) {
+        ssize_t r = write(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r; n -= (size_t)r;
+    }
+    return true;
+}
+static bool writeString(int fd, const string &s) {
+    uint32_t n = (uint32_t)s.size();
+    return writeFull(fd, &n, sizeof(n)) && writeFull(fd, s.data(), n);
+}
+static bool readString(int fd, string &s) {
+    uint32_t n;
+    if (!readFull(fd, &n, sizeof(n))) return false;
+    s.assign(n, '\0');
+    return n == 0 || readFull(fd, &s[0], n);
+}
+// 작업 하나 전송 (source가 있으면 파일 대신 그 내용을 어셈블)
+static bool writeJob(int fd, const string &src, const string &dir, const string *source = nullptr) {
+    uint8_t hasSource = source != nullptr;
+    return writeString(fd, src) && writeString(fd, dir) && writeFull(fd, &hasSource, 1)
+        && (!hasSource || writeString(fd, *source));
+}
+static bool readJob(int fd, string &src, string &dir, bool &hasSource, string &source) {
+    uint8_t flag;
+    if (!readString(fd, src) || !readString(fd, dir) || !readFull(fd, &flag, 1)) return false;
+    hasSource = flag != 0;
+    if (!hasSource) { source.clear(); return true; }
+    return readString(fd, source);
+}
+
+// 상대 경로를 현재 디렉토리 기준 절대 경로로 변환 (worker가 chdir하므로 필요)
+static string absolutePath(const string &p) {
+    if (!p.empty() && p[0] == '/') return p;
+    char buf[4096];
+    if (!getcwd(buf, sizeof(buf))) return p;
+    return string(buf) + "/" + p;
+}
+// 중간 디렉토리까지 생성 (mkdir -p)
+static bool makeDirs(const string &path) {
+    for (size_t i = 1; i <= path.size(); ++i) {
+        if (i < path.size() && path[i] != '/') continue;
+        string part = path.substr(0, i);
+        if (mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) return false;
+    }
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+/**
+ * 공유 메모리 결과 영역 (-m)
+ * worker마다 memfd 하나를 fork 전에 MAP_SHARED로 매핑해 두고, worker는 출력 파일 내용을
+ * 이 영역에 직접 써 넣는다. 파이프로는 완료 통지(위치와 길이)만 보내므로
+ * 큰 목적 프로그램도 파이프를 거쳐 복사되지 않고 parent가 매핑에서 바로 읽는다.
+ *
+ * 영역 맨 앞은 ResultRing header이고 그 뒤로 레코드가 이어진다.
+ *   worker(생산자)는 레코드를 다 쓴 뒤 head를 옮기고, parent(소비자)는 처리한 만큼 tail을 옮긴다.
+ *   worker 하나에는 처리 중인 작업이 하나뿐이므로 ring이 비면(head == tail) 처음 위치로 되감고,
+ *   한 작업의 결과가 커지면 감아 돌지 않고 예약해 둔 주소 범위 안에서 memfd를 ftruncate로 늘린다.
+ * 레코드: ResultRecord, 이름, 데이터 (각각 8바이트 정렬). 이름이 빈 레코드는 진단 메시지
+ */
+struct ResultRing {
+    char magic[8];          // "SICRES1"
+    atomic<uint64_t> size;  // 현재 memfd 크기
+    atomic<uint64_t> head;  // worker가 기록을 마친 위치
+    atomic<uint64_t> tail;  // parent가 처리를 마친 위치
+};
+struct ResultRecord { uint32_t nameLen; uint32_t reserved; uint64_t dataLen; };
+const uint64_t RING_DATA_START = 64;
+const uint64_t RING_INITIAL = 1ULL << 20;
+const uint64_t RING_RESERVE = 1ULL << 32; // 작업 하나의 결과 최대 크기 (가상 주소만 예약)
+static inline uint64_t align8(uint64_t v) { return (v + 7) & ~7ULL; }
+
+struct ResultArena {
+    int fd = -1;
+    char *base = nullptr;
+    ResultRing *ring() const { return (ResultRing*)base; }
+    bool create() {
+        fd = memfd_create("sic-asm-result", 0);
+        if (fd < 0) { perror("memfd_create"); return false; }
+        if (ftruncate(fd, RING_INITIAL) != 0) { perror("ftruncate"); close(fd); fd = -1; return false; }
+        void *p = mmap(nullptr, RING_RESERVE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd, 0);
+        if (p == MAP_FAILED) { perror("mmap"); close(fd); fd = -1; return false; }
+        base = (char*)p;
+        memcpy(ring()->magic, "SICRES1", 8);
+        ring()->size.store(RING_INITIAL);
+        reset();
+        return true;
+    }
+    void reset() { ring()->head.store(RING_DATA_START); ring()->tail.store(RING_DATA_START); }
+    // end 위치까지 쓸 수 있도록 memfd 크기를 늘림
+    bool ensure(uint64_t end) {
+        uint64_t sz = ring()->size.load();
+        if (end <= sz) return true;
+        if (end > RING_RESERVE) return false;
+        while (sz < end) sz *= 2;
+        sz = min(sz, RING_RESERVE);
+        if (ftruncate(fd, (off_t)sz) != 0) return false;
+        ring()->size.store(sz);
+        return true;
+    }
+    void destroy() {
+        if (base) munmap(base, RING_RESERVE);
+        if (fd >= 0) close(fd);
+        base = nullptr; fd = -1;
+    }
+};
+
+/**
+ * ResultArena에 레코드를 직접 써 넣는 streambuf
+ * begin(name)으로 레코드를 열고 ostream으로 내용을 쓴 뒤 end()로 길이를 기록하고 head를 옮긴다.
+ * 쓰는 도중 공간이 모자라면 arena를 늘리고, 예약 범위를 넘으면 overflowed를 세운다.
+ */
+class ArenaWriter : public streambuf {
+public:
+    ResultArena *arena = nullptr;
+    bool overflowed = false;
+    void begin(const string &name) {
+        recStart = arena->ring()->head.load();
+        dataStart = recStart + sizeof(ResultRecord) + align8(name.size());
+        if (overflowed || !arena->ensure(dataStart)) { overflowed = true; setp(nullptr, nullptr); return; }
+        ResultRecord *r = (ResultRecord*)(arena->base + recStart);
+        r->nameLen = (uint32_t)name.size(); r->reserved = 0; r->dataLen = 0;
+        memcpy(arena->base + recStart + sizeof(ResultRecord), name.data(), name.size());
+        setp(arena->base + dataStart, arena->base + arena->ring()->size.load());
+    }
+    void end() {
+        if (overflowed) return;
+        uint64_t dataEnd = (uint64_t)(pptr() - arena->base);
+        ((ResultRecord*)(arena->base + recStart))->dataLen = dataEnd - dataStart;
+        arena->ring()->head.store(align8(dataEnd), memory_order_release);
+    }
+protected:
+    int_type overflow(int_type c) override {
+        if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+        if (!grow(1)) return traits_type::eof();
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+    streamsize xsputn(const char *s, streamsize n) override {
+        if (epptr() - pptr() < n && !grow((uint64_t)n)) return 0;
+        memcpy(pptr(), s, (size_t)n);
+        pbump((int)n);
+        return n;
+    }
+private:
+    uint64_t recStart = 0, dataStart = 0;
+    bool grow(uint64_t need) {
+        if (overflowed) return false;
+        char *p = pptr();
+        if (!arena->ensure((uint64_t)(p - arena->base) + need)) { overflowed = true; return false; }
+        setp(p, arena->base + arena->ring()->size.load());
+        return true;
+    }
+};
+
+// worker 프로세스의 출력 hook 대상
+static ArenaWriter *WORKER_WRITER = nullptr;
+static ostream *WORKER_STREAM = nullptr;
+
+// ---------- supervisor ----------
+/**
+ * worker 감독 (worker pool에서 사용)
+ * - PR_SET_CHILD_SUBREAPER: worker가 남긴 손자 프로세스도 init 대신 이 프로세스로 넘어와 회수된다.
+ * - SIGCHLD handler가 waitpid(-1, WNOHANG)로 끝난 자식을 모두 회수하고 (pid, status)를 self-pipe에 쓴다.
+ *   주 루프는 worker 파이프와 함께 이 파이프를 poll하므로, 쉬고 있던 worker가 죽어도 바로 알고 다시 띄운다.
+ * - CPU 시간 예산 (-L 초): worker는 작업을 시작할 때마다 RLIMIT_CPU soft limit을
+ *   (지금까지 쓴 CPU 시간 + 예산)으로 맞춘다. 넘으면 커널이 SIGXCPU로 worker를 끝낸다.
+ */
+static int REAP_PIPE[2] = {-1, -1};
+static int CPU_BUDGET_SEC = 0;
+static const int MAX_ATTEMPTS = 2; // 작업 하나를 worker에 맡기는 최대 횟수 (worker pool, daemon)
+
+static void reapChildren(int) {
+    int saved = errno, status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        int rec[2] = {(int)pid, status};
+        if (write(REAP_PIPE[1], rec, sizeof(rec)) < 0) {}
+    }
+    errno = saved;
+}
+
+static bool installReaper() {
+    if (prctl(PR_SET_CHILD_SUBREAPER, 1) != 0) perror("prctl(PR_SET_CHILD_SUBREAPER)");
+    if (pipe2(REAP_PIPE, O_NONBLOCK | O_CLOEXEC) != 0) { perror("pipe: reap error"); return false; }
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = reapChildren;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigaction(SIGCHLD, &sa, nullptr);
+    return true;
+}
+
+// self-pipe에 쌓인 (pid, status)를 모두 읽음
+static void drainReaped(vector<pair<pid_t,int>> &out) {
+    int rec[2];
+    while (read(REAP_PIPE[0], rec, sizeof(rec)) == (ssize_t)sizeof(rec)) out.push_back({(pid_t)rec[0], rec[1]});
+}
+
+// worker 쪽: 다음 작업에 쓸 CPU 시간 한도 설정
+static void applyCpuBudget() {
+    if (CPU_BUDGET_SEC <= 0) return;
+    struct rusage ru;
+    struct rlimit rl;
+    if (getrusage(RUSAGE_SELF, &ru) != 0 || getrlimit(RLIMIT_CPU, &rl) != 0) return;
+    rlim_t limit = (rlim_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + 1 + CPU_BUDGET_SEC);
+    if (rl.rlim_max != RLIM_INFINITY && limit > rl.rlim_max) limit = rl.rlim_max;
+    rl.rlim_cur = limit;
+    setrlimit(RLIMIT_CPU, &rl);
+}
+
+// worker 종료 상태 설명
+static string describeExit(int status) {
+    if (WIFSIGNALED(status)) {
+        if (WTERMSIG(status) == SIGXCPU) return "CPU limit exceeded (" + to_string(CPU_BUDGET_SEC) + "s)";
+        return "crashed (signal " + to_string(WTERMSIG(status)) + ")";
+    }
+    return "worker exited (status " + to_string(WEXITSTATUS(status)) + ")";
+}
+
+/**
+ * worker 본체: ptc에서 작업을 받아 출력 디렉토리로 이동한 뒤 pass1/pass2 수행
+ * 어셈블러의 cout 출력(목적 코드 echo)은 버리고, cerr 출력과 ERRORS만 진단 메시지로 돌려보낸다.
+ * arena가 있으면 출력 파일과 진단 메시지를 arena에 레코드로 쓰고 통지만 보낸다.
+ * 이때 cout 출력도 "@stdout" 레코드로 남긴다 (daemon이 클라이언트에 그대로 전달).
+ * ptc가 닫히면 종료
+ */
+static void workerLoop(int in, int out, ResultArena *arena) {
+    ArenaWriter writer;
+    ostream arenaStream(&writer);
+    if (arena) {
+        writer.arena = arena;
+        WORKER_WRITER = &writer;
+        WORKER_STREAM = &arenaStream;
+        OUTPUT_HOOK = [](const string &fname) -> ostream* { WORKER_WRITER->begin(fname); WORKER_STREAM->clear(); return WORKER_STREAM; };
+        OUTPUT_DONE_HOOK = [](ostream &os) { os.flush(); WORKER_WRITER->end(); };
+    }
+    string src, dir, source;
+    bool hasSource;
+    while (readJob(in, src, dir, hasSource, source)) {
+        JobReply rep{0, 0, 0, 0, 0, 0};
+        applyCpuBudget();
+        if (arena) {
+            ResultRing *ring = arena->ring();
+            if (ring->head.load() == ring->tail.load(memory_order_acquire)) arena->reset();
+            rep.offset = ring->head.load();
+            writer.overflowed = false;
+        }
+        string text;
+        stringstream diag, echo;
+        streambuf *oldOut = cout.rdbuf(arena ? echo.rdbuf() : nullptr);
+        streambuf *oldErr = cerr.rdbuf(diag.rdbuf());
+        if (!dir.empty() && (!makeDirs(dir) || chdir(dir.c_str()) != 0)) {
+            rep.status = 2; text = "Cannot enter output directory: " + dir + "\n";
+        } else if (!hasSource && access(src.c_str(), R_OK) != 0) {
+            rep.status = 2; text = "Cannot open source file: " + src + "\n";
+        } else {
+            if (hasSource) {
+                istringstream iss(source);
+                assignPass1(parseSourceStream(iss));
+                writePass1Files();
+            } else doPass1(src);
+            doPass2(src);
+            text = diag.str();
+            for (auto &e : ERRORS) text += e + "\n";
+            rep.errCount = (uint32_t)ERRORS.size();
+            rep.status = ERRORS.empty() ? 0 : 1;
+        }
+        cout.rdbuf(oldOut);
+        cerr.rdbuf(oldErr);
+        if (arena) {
+            if (echo.tellp() > 0) { writer.begin("@stdout"); arenaStream.clear(); arenaStream << echo.rdbuf() << flush; writer.end(); }
+            if (!text.empty()) { writer.begin(""); arenaStream.clear(); arenaStream << text << flush; writer.end(); }
+            if (writer.overflowed) {
+                rep.status = 2;
+                text = "Result exceeds shared memory limit (" + to_string(RING_RESERVE >> 20) + " MB)\n";
+            } else text.clear();
+            rep.length = arena->ring()->head.load() - rep.offset;
+        }
+        rep.textLen = (uint32_t)text.size();
+        if (!writeFull(out, &rep, sizeof(rep)) || !writeFull(out, text.data(), text.size())) break;
+    }
+    _exit(0);
+}
+
+// daemon의 listen 소켓 (worker는 물려받은 소켓을 닫는다)
+static int DAEMON_LISTEN_FD = -1;
+
+// worker 하나를 fork. 자식은 다른 worker들의 파이프 끝과 공유 메모리를 닫아 EOF가 제대로 전달되게 한다.
+static bool spawnWorker(FarmWorker &w, const vector<FarmWorker> &all, ResultArena *arena) {
+    int ptc[2], ctp[2];
+    if (pipe(ptc) == -1) { perror("pipe: ptc error"); return false; }
+    if (pipe(ctp) == -1) { perror("pipe: ctp error"); close(ptc[0]); close(ptc[1]); return false; }
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fail to fork");
+        close(ptc[0]); close(ptc[1]); close(ctp[0]); close(ctp[1]);
+        return false;
+    }
+    if (pid == 0) {
+        if (DAEMON_LISTEN_FD >= 0) close(DAEMON_LISTEN_FD);
+        if (REAP_PIPE[0] >= 0) { signal(SIGCHLD, SIG_DFL); close(REAP_PIPE[0]); close(REAP_PIPE[1]); }
+        for (auto &o : all) {
+            if (o.pid > 0) { close(o.ptc); close(o.ctp); }
+            if (o.arena && o.arena != arena) o.arena->destroy();
+        }
+        close(ptc[1]); close(ctp[0]);
+        workerLoop(ptc[0], ctp[1], arena);
+    }
+    close(ptc[0]); close(ctp[1]);
+    if (arena) arena->reset();
+    w = FarmWorker{pid, ptc[1], ctp[0], -1, arena};
+    return true;
+}
+
+// worker 종료 처리 (파이프 닫고 회수). 종료 상태 반환
+static int retireWorker(FarmWorker &w) {
+    int status = 0;
+    if (w.ptc >= 0) close(w.ptc);
+    if (w.ctp >= 0) close(w.ctp);
+    while (waitpid(w.pid, &status, 0) < 0 && errno == EINTR) {}
+    w = FarmWorker{-1, -1, -1, -1, w.arena};
+    return status;
+}
+
+// 작업 하나의 레코드를 차례로 fn(이름, 데이터, 길이)에 넘김. fn이 false를 돌려주면 중단
+template<class Fn> static void forEachRecord(const ResultArena &arena, const JobReply &rep, Fn fn) {
+    uint64_t pos = rep.offset, end = rep.offset + rep.length;
+    while (pos + sizeof(ResultRecord) <= end) {
+        const ResultRecord *r = (const ResultRecord*)(arena.base + pos);
+        const char *name = arena.base + pos + sizeof(ResultRecord);
+        const char *data = name + align8(r->nameLen);
+        if (!fn(string(name, r->nameLen), data, r->dataLen)) return;
+        pos = align8((uint64_t)(data - arena.base) + r->dataLen);
+    }
+}
+
+// 파일 하나를 통째로 씀
+static bool writeWholeFile(const string &path, const char *data, size_t len) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok = writeFull(fd, data, len);
+    return close(fd) == 0 && ok;
+}
+
+/**
+ * 공유 메모리에 놓인 작업 결과를 처리: 이름 있는 레코드는 outDir에 그 이름의 파일로 쓰고,
+ * 진단 메시지 레코드는 text 뒤에 붙인다. 데이터는 매핑에서 바로 write하며 처리 후 tail을 옮긴다.
+ * '@'로 시작하는 레코드(@stdout)는 파일이 아니므로 건너뛴다.
+ */
+static bool consumeResults(ResultArena &arena, const JobReply &rep, const string &outDir, string &text) {
+    bool ok = true;
+    if (rep.length > 0 && !makeDirs(outDir)) { text += "Cannot create output directory: " + outDir + "\n"; ok = false; }
+    if (ok) forEachRecord(arena, rep, [&](const string &name, const char *data, uint64_t len) {
+        if (name.empty()) text.append(data, len);
+        else if (name[0] != '@' && !writeWholeFile(outDir + "/" + name, data, len)) {
+            text += "Cannot write " + outDir + "/" + name + "\n";
+            ok = false;
+        }
+        return ok;
+    });
+    arena.ring()->tail.store(rep.offset + rep.length, memory_order_release);
+    return ok;
+}
+
+/**
+ * 소스 목록을 nWorkers개의 worker로 어셈블하고, 끝나는 순서대로 결과를 출력
+ * 각 작업의 출력 파일(OBJFILE.obj, INTFILE.txt ...)은 outRoot/<소스 이름>/ 에 생성된다.
+ * sharedMem이면 worker는 디스크에 쓰지 않고 결과를 공유 메모리로 넘기며 parent가 파일을 만든다.
+ * worker가 죽으면(SIGCHLD로 회수) 새 worker를 띄우고, 처리 중이던 작업은 한 번 더 시도한다.
+ * CPU 시간 예산을 넘겨 끝난 작업은 다시 시도하지 않는다.
+ * @return 모든 작업이 오류 없이 끝나면 0, 아니면 1
+ */
+int runFarm(const vector<string> &sources, const string &outRoot, int nWorkers, bool sharedMem) {
+    vector<FarmJob> jobs;
+    unordered_map<string,int> stemCount;
+    string root = absolutePath(outRoot);
+    for (auto &s : sources) {
+        string base = s.substr(s.find_last_of('/') == string::npos ? 0 : s.find_last_of('/') + 1);
+        string stem = base.substr(0, base.find_last_of('.'));
+        if (stem.empty()) stem = base;
+        int n = ++stemCount[stem];
+        if (n > 1) stem += "_" + to_string(n);
+        jobs.push_back(FarmJob{absolutePath(s), root + "/" + stem});
+    }
+    if (nWorkers < 1) nWorkers = 1;
+    if ((size_t)nWorkers > jobs.size()) nWorkers = (int)jobs.size();
+
+    signal(SIGPIPE, SIG_IGN); // 죽은 worker에 쓰면 write 실패로 처리
+    if (!installReaper()) return 1;
+    statsPhase("farm", 0);
+    LIVE.jobsTotal = jobs.size();
+    auto t0 = chrono::steady_clock::now();
+    vector<ResultArena> arenas(sharedMem ? nWorkers : 0);
+    for (auto &a : arenas) if (!a.create()) return 1;
+    vector<FarmWorker> workers(nWorkers, FarmWorker{-1, -1, -1, -1, nullptr});
+    for (int i = 0; i < nWorkers; ++i) {
+        workers[i].arena = sharedMem ? &arenas[i] : nullptr;
+        if (!spawnWorker(workers[i], workers, workers[i].arena)) return 1;
+    }
+
+    size_t next = 0, done = 0;
+    deque<int> retry;                    // 다시 시도할 작업 (새 작업보다 먼저)
+    vector<int> attempts(jobs.size(), 0);
+    int ok = 0, withErrors = 0, failed = 0, restarts = 0;
+    auto pending = [&]() { return !retry.empty() || next < jobs.size(); };
+    auto report = [&](int job, const string &result, const string &text) {
+        ++done;
+        LIVE.jobsDone = done;
+        cout << "[" << done << "/" << jobs.size() << "] " << sources[job] << " -> " << jobs[job].outDir << ": " << result << "\n";
+        if (!text.empty()) {
+            istringstream iss(text); string line;
+            while (getline(iss, line)) cout << "    " << line << "\n";
+        }
+        cout << flush;
+    };
+    // worker 하나가 끝남 (SIGCHLD로 회수됨): 처리 중이던 작업을 정리하고 남은 작업이 있으면 새 worker를 띄움
+    auto workerDied = [&](FarmWorker &w, int status) {
+        int job = w.job;
+        if (w.ptc >= 0) close(w.ptc);
+        if (w.ctp >= 0) close(w.ctp);
+        w = FarmWorker{-1, -1, -1, -1, w.arena};
+        if (w.arena) w.arena->reset();
+        if (job >= 0) {
+            bool cpuLimit = WIFSIGNALED(status) && WTERMSIG(status) == SIGXCPU;
+            if (!cpuLimit && attempts[job] < MAX_ATTEMPTS) {
+                retry.push_back(job);
+                cerr << "worker " << describeExit(status) << " on " << sources[job] << ", retrying\n";
+            } else { ++failed; report(job, describeExit(status), ""); }
+        }
+        if (pending() && spawnWorker(w, workers, w.arena)) ++restarts;
+    };
+
+    vector<pair<pid_t,int>> reaped;
+    while (done < jobs.size()) {
+        pollStats();
+        // 대기 중인 worker에 작업 배분
+        for (auto &w : workers) {
+            if (w.pid <= 0 || w.job >= 0 || w.ctp < 0 || !pending()) continue;
+            if (!retry.empty()) { w.job = retry.front(); retry.pop_front(); }
+            else w.job = (int)next++;
+            ++attempts[w.job];
+            string dir = w.arena ? "" : jobs[w.job].outDir;
+            // 쓰기 실패: worker가 이미 죽음. 작업은 회수될 때 다시 시도된다
+            if (!writeJob(w.ptc, jobs[w.job].src, dir)) { close(w.ctp); w.ctp = -1; }
+        }
+        bool alive = false;
+        for (auto &w : workers) alive = alive || w.pid > 0;
+        if (!alive) { // worker를 더 띄울 수 없음: 남은 작업은 실패 처리
+            while (!retry.empty()) { ++failed; report(retry.front(), "not run (no worker)", ""); retry.pop_front(); }
+            while (next < jobs.size()) { ++failed; report((int)next++, "not run (no worker)", ""); }
+            break;
+        }
+        vector<pollfd> fds(1, pollfd{REAP_PIPE[0], POLLIN, 0});
+        vector<int> owner(1, -1);
+        for (size_t i = 0; i < workers.size(); ++i) {
+            if (workers[i].pid <= 0 || workers[i].job < 0 || workers[i].ctp < 0) continue;
+            fds.push_back(pollfd{workers[i].ctp, POLLIN, 0});
+            owner.push_back((int)i);
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+        for (size_t k = 1; k < fds.size(); ++k) {
+            if (!(fds[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            FarmWorker &w = workers[owner[k]];
+            JobReply rep;
+            string text;
+            bool got = readFull(w.ctp, &rep, sizeof(rep));
+            if (got) {
+                text.assign(rep.textLen, '\0');
+                got = rep.textLen == 0 || readFull(w.ctp, &text[0], rep.textLen);
+            }
+            // 응답 없이 파이프가 닫힘: worker가 죽는 중. 작업 처리는 회수할 때
+            if (!got) { close(w.ctp); w.ctp = -1; continue; }
+            int job = w.job;
+            w.job = -1;
+            if (w.arena && !consumeResults(*w.arena, rep, jobs[job].outDir, text)) rep.status = 2;
+            if (rep.status == 0) { ++ok; report(job, "OK", text); }
+            else if (rep.status == 1) { ++withErrors; report(job, to_string(rep.errCount) + " error(s)", text); }
+            else { ++failed; report(job, "FAILED", text); }
+        }
+        reaped.clear();
+        drainReaped(reaped);
+        for (auto &pr : reaped)
+            for (auto &w : workers) if (w.pid == pr.first) { workerDied(w, pr.second); break; }
+    }
+
+    // 종료: ptc를 닫으면 worker가 끝나고, SIGCHLD로 모두 회수될 때까지 기다린다
+    size_t alive = 0;
+    for (auto &w : workers) if (w.pid > 0) { close(w.ptc); w.ptc = -1; ++alive; }
+    while (alive > 0) {
+        pollfd pfd{REAP_PIPE[0], POLLIN, 0};
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR) break;
+        reaped.clear();
+        drainReaped(reaped);
+        for (auto &pr : reaped)
+            for (auto &w : workers) if (w.pid == pr.first) { if (w.ctp >= 0) close(w.ctp); w.pid = -1; --alive; break; }
+    }
+    for (auto &a : arenas) a.destroy();
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    cout << "=== " << jobs.size() << " source(s): " << ok << " OK, " << withErrors << " with errors, "
+         << failed << " failed (" << nWorkers << " workers, " << restarts << " restarted, "
+         << fixed << setprecision(3) << secs << "s) ===\n";
+    return (withErrors == 0 && failed == 0) ? 0 : 1;
+}
+
+// ---------- daemon ----------
+/**
+ * 상주 어셈블러 (-S 소켓 경로)
+ * Unix domain socket으로 "이 소스를 이 디렉토리에 어셈블" 요청을 받는다.
+ * - 연결은 미리 띄워 둔 스레드들이 각자 accept해서 처리한다.
+ * - 어셈블 자체는 OPTAB이 적재된 채 fork해 둔 worker에서 공유 메모리 모드로 수행한다.
+ *   (어셈블러 상태가 전역 변수라 한 프로세스에서 여러 작업을 동시에 돌릴 수 없고, 비정상 종료도 격리된다)
+ *   worker에는 해시를 계산한 소스 내용을 그대로 보내므로 캐시 키와 어셈블한 내용이 항상 같다.
+ * - 죽은 worker는 supervisor 스레드 하나만 다시 fork한다 (요청 스레드는 fork하지 않는다).
+ *   다시 띄우지 못해 살아 있는 worker가 없으면 요청은 기다리지 않고 실패로 돌아간다.
+ * - 소스 내용이 바뀌지 않았으면 worker를 거치지 않고 기억해 둔 결과를 다시 써 준다.
+ *
+ * 요청: [길이][소스 절대 경로][길이][출력 디렉토리]
+ * 응답: [status][길이][표준 출력 내용][길이][진단 메시지]
+ */
+struct CachedResult {
+    uint64_t hash = 0;                  // 소스 내용의 해시
+    int32_t status = 0;
+    string echo;                        // 작업의 표준 출력
+    string diag;
+    vector<pair<string,string>> files;  // 출력 파일 이름, 내용
+    size_t bytes = 0;
+};
+
+struct DaemonState {
+    vector<ResultArena> arenas;
+    vector<FarmWorker> workers;
+    vector<char> busy;
+    mutex poolLock;
+    condition_variable poolIdle;
+    condition_variable respawnWanted; // pid <= 0인 슬롯이 생기면 supervisor를 깨움
+    bool respawnFailed = false;       // 마지막 재시작 시도에서 띄우지 못한 슬롯이 있음
+    bool stopping = false;
+
+    // 결과 캐시: 소스 경로 -> 결과 (전체 크기가 cacheLimit를 넘으면 오래 안 쓴 것부터 버림)
+    mutex cacheLock;
+    list<string> lru;
+    unordered_map<string, pair<CachedResult, list<string>::iterator>> cache;
+    size_t cacheBytes = 0;
+    size_t cacheLimit = 256u << 20;
+
+    mutex logLock;
+    atomic<uint64_t> requests{0}, hits{0};
+};
+
+// FNV-1a 64비트 해시
+static uint64_t fnv1a(const string &s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) { h ^= c; h *= 1099511628211ULL; }
+    return h;
+}
+
+static bool cacheLookup(DaemonState &d, const string &src, uint64_t hash, CachedResult &out) {
+    lock_guard<mutex> g(d.cacheLock);
+    auto it = d.cache.find(src);
+    if (it == d.cache.end() || it->second.first.hash != hash) return false;
+    d.lru.splice(d.lru.begin(), d.lru, it->second.second);
+    out = it->second.first;
+    return true;
+}
+
+static void cacheStore(DaemonState &d, const string &src, const CachedResult &res) {
+    lock_guard<mutex> g(d.cacheLock);
+    auto it = d.cache.find(src);
+    if (it != d.cache.end()) {
+        d.cacheBytes -= it->second.first.bytes;
+        d.lru.erase(it->second.second);
+        d.cache.erase(it);
+    }
+    if (res.bytes > d.cacheLimit) return;
+    while (d.cacheBytes + res.bytes > d.cacheLimit && !d.lru.empty()) {
+        auto old = d.cache.find(d.lru.back());
+        d.cacheBytes -= old->second.first.bytes;
+        d.cache.erase(old);
+        d.lru.pop_back();
+    }
+    d.lru.push_front(src);
+    d.cache.emplace(src, make_pair(res, d.lru.begin()));
+    d.cacheBytes += res.bytes;
+}
+
+/**
+ * 쉬고 있는 worker 하나를 빌려 source를 어셈블
+ * worker가 죽어 있거나 작업 도중 죽으면 회수하고 supervisor에 재시작을 맡긴 뒤 같은 작업을 다시 보낸다.
+ * - 작업을 보내는 단계에서 실패(이미 죽어 있던 worker)하면 작업이 전달되지 않았으므로 시도 횟수에 넣지 않는다.
+ * - 작업을 받은 뒤 죽으면 MAX_ATTEMPTS번까지 다시 시도하고, CPU 시간 한도로 끝난 작업은 다시 시도하지 않는다.
+ */
+static void assembleOnWorker(DaemonState &d, const string &src, const string &source, CachedResult &res) {
+    int attempts = 0;
+    for (size_t tries = 0; ; ++tries) {
+        size_t idx;
+        {
+            unique_lock<mutex> g(d.poolLock);
+            for (;;) {
+                bool alive = false;
+                for (idx = 0; idx < d.workers.size(); ++idx) {
+                    if (d.workers[idx].pid <= 0) continue;
+                    alive = true;
+                    if (!d.busy[idx]) break;
+                }
+                if (idx < d.workers.size()) break;
+                if (!alive && d.respawnFailed) {
+                    res.status = 2;
+                    res.diag = "No assembler worker available (respawn failed)\n";
+                    return;
+                }
+                d.poolIdle.wait(g);
+            }
+            d.busy[idx] = 1;
+        }
+        FarmWorker &w = d.workers[idx];
+        JobReply rep;
+        string text;
+        bool sent = writeJob(w.ptc, src, "", &source);
+        bool ok = sent && readFull(w.ctp, &rep, sizeof(rep));
+        if (ok) {
+            text.assign(rep.textLen, '\0');
+            ok = rep.textLen == 0 || readFull(w.ctp, &text[0], rep.textLen);
+        }
+        if (ok) {
+            res = CachedResult();
+            res.status = rep.status;
+            res.diag = text;
+            forEachRecord(*w.arena, rep, [&](const string &name, const char *data, uint64_t len) {
+                if (name.empty()) res.diag.append(data, len);
+                else if (name == "@stdout") res.echo.assign(data, len);
+                else res.files.emplace_back(name, string(data, len));
+                res.bytes += name.size() + len;
+                return true;
+            });
+            w.arena->ring()->tail.store(rep.offset + rep.length, memory_order_release);
+        }
+        lock_guard<mutex> g(d.poolLock);
+        d.busy[idx] = 0;
+        d.poolIdle.notify_one();
+        if (ok) return;
+
+        int status = retireWorker(w);
+        d.respawnFailed = false; // 재시작을 시도할 때까지는 기다리게 함
+        d.respawnWanted.notify_one();
+        if (sent) ++attempts;
+        bool cpuLimit = WIFSIGNALED(status) && WTERMSIG(status) == SIGXCPU;
+        if (cpuLimit || attempts >= MAX_ATTEMPTS || tries >= d.workers.size() + MAX_ATTEMPTS) {
+            res.status = 2;
+            res.diag = "Assembler " + describeExit(status) + "\n";
+            return;
+        }
+        lock_guard<mutex> lg(d.logLock);
+        cerr << "[daemon] worker " << describeExit(status) << " on " << src << ", retrying\n";
+    }
+}
+
+/**
+ * supervisor 스레드: 빈 슬롯(pid <= 0)의 worker를 다시 띄움
+ * fork는 이 스레드에서만 하고, 그동안 poolLock을 잡아 worker 목록이 바뀌지 않게 한다.
+ * 띄우지 못하면 respawnFailed를 세워 기다리는 요청을 깨우고 1초 뒤 다시 시도한다.
+ */
+static void superviseWorkers(DaemonState &d) {
+    unique_lock<mutex> g(d.poolLock);
+    auto anyDead = [&]() {
+        for (auto &w : d.workers) if (w.pid <= 0) return true;
+        return false;
+    };
+    while (!d.stopping) {
+        if (!anyDead()) { d.respawnWanted.wait(g); continue; }
+        bool failed = false;
+        for (auto &w : d.workers) {
+            if (w.pid > 0) continue;
+            if (spawnWorker(w, d.workers, w.arena)) {
+                lock_guard<mutex> lg(d.logLock);
+                cerr << "[daemon] restarted worker " << w.pid << "\n";
+            } else failed = true;
+        }
+        d.respawnFailed = failed;
+        d.poolIdle.notify_all();
+        if (failed) d.respawnWanted.wait_for(g, chrono::seconds(1));
+    }
+}
+
+// 연결 하나 처리
+static void serveRequest(DaemonState &d, int conn) {
+    string src, dir;
+    if (!readString(conn, src) || !readString(conn, dir)) return;
+    ++d.requests;
+    auto t0 = chrono::steady_clock::now();
+    CachedResult res;
+    bool hit = false;
+    ifstream ifs(src, ios::binary);
+    if (!ifs) {
+        res.status = 2;
+        res.diag = "Cannot open source file: " + src + "\n";
+    } else {
+        string content((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+        uint64_t hash = fnv1a(content);
+        hit = cacheLookup(d, src, hash, res);
+        if (hit) ++d.hits;
+        else {
+            assembleOnWorker(d, src, content, res);
+            res.hash = hash;
+            if (res.status != 2) cacheStore(d, src, res);
+        }
+    }
+    if (!res.files.empty() && !makeDirs(dir)) { res.status = 2; res.diag += "Cannot create output directory: " + dir + "\n"; }
+    else {
+        for (auto &f : res.files) {
+            if (writeWholeFile(dir + "/" + f.first, f.second.data(), f.second.size())) continue;
+            res.status = 2;
+            res.diag += "Cannot write " + dir + "/" + f.first + "\n";
+        }
+    }
+    writeFull(conn, &res.status, sizeof(res.status)) && writeString(conn, res.echo) && writeString(conn, res.diag);
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    lock_guard<mutex> g(d.logLock);
+    cerr << "[daemon] " << src << " -> " << dir << ": status " << res.status << (hit ? " (cached)" : "")
+         << " " << fixed << setprecision(2) << ms << "ms\n";
+}
+
+/**
+ * daemon 실행: 소켓을 열고 worker nWorkers개, 연결 처리 스레드 nThreads개를 띄운 뒤 계속 요청을 처리
+ */
+int runDaemon(const string &path, int nWorkers, int nThreads) {
+    int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (lfd < 0) { perror("socket"); return 1; }
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) { cerr << "Socket path too long: " << path << "\n"; close(lfd); return 1; }
+    strcpy(addr.sun_path, path.c_str());
+    unlink(path.c_str()); // 이전 daemon이 남긴 소켓 파일
+    if (bind(lfd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(lfd, 64) < 0) { perror("bind/listen"); close(lfd); return 1; }
+    DAEMON_LISTEN_FD = lfd;
+    signal(SIGPIPE, SIG_IGN);
+
+    DaemonState d;
+    d.arenas.resize(max(1, nWorkers));
+    d.workers.assign(d.arenas.size(), FarmWorker{-1, -1, -1, -1, nullptr});
+    d.busy.assign(d.arenas.size(), 0);
+    for (size_t i = 0; i < d.arenas.size(); ++i) {
+        if (!d.arenas[i].create()) return 1;
+        d.workers[i].arena = &d.arenas[i];
+        if (!spawnWorker(d.workers[i], d.workers, d.workers[i].arena)) return 1;
+    }
+    cerr << "[daemon] listening on " << path << " (" << d.workers.size() << " workers, " << nThreads << " threads)\n";
+
+    thread supervisor(superviseWorkers, ref(d));
+    vector<thread> pool;
+    for (int t = 0; t < max(1, nThreads); ++t) {
+        pool.emplace_back([&d, lfd]() {
+            for (;;) {
+                int conn = accept(lfd, nullptr, nullptr);
+                if (conn < 0) { if (errno == EINTR) continue; perror("accept"); return; }
+                serveRequest(d, conn);
+                close(conn);
+            }
+        });
+    }
+    for (auto &t : pool) t.join();
+    {
+        lock_guard<mutex> g(d.poolLock);
+        d.stopping = true;
+        d.respawnWanted.notify_one();
+    }
+    supervisor.join();
+    for (auto &w : d.workers) if (w.pid > 0) retireWorker(w);
+    for (auto &a : d.arenas) a.destroy();
+    close(lfd);
+    return 1;
+}
+
+/**
+ * daemon에 어셈블을 맡김 (출력 파일은 현재 디렉토리에 생성)
+ * @return 종료 코드. daemon에 연결할 수 없으면 -1 (직접 어셈블)
+ */
+int runClient(const string &path, const string &src) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) { close(fd); return -1; }
+    int32_t status;
+    string echo, diag, srcPath = absolutePath(src), cwd = absolutePath("");
+    if (char *rp = realpath(src.c_str(), nullptr)) { srcPath = rp; free(rp); }
+    if (!cwd.empty() && cwd.back() == '/') cwd.pop_back();
+    bool ok = writeString(fd, srcPath) && writeString(fd, cwd)
+           && readFull(fd, &status, sizeof(status)) && readString(fd, echo) && readString(fd, diag);
+    close(fd);
+    if (!ok) { cerr << "Lost connection to assembler daemon " << path << "\n"; return 1; }
+    cout << echo << flush;
+    if (status == 2) { cerr << diag; return 1; }
+    return 0;
+}
+
+// ---------- fuzzing ----------
+/**
+ * 입력 검사용 fuzz 대상
+ * parse    : 소스 텍스트 파싱 (parseSourceStream)
+ * constant : BYTE/WORD/리터럴 상수 (bytesFromConstant)
+ * expr     : EQU/ORG 표현식 (evalExpression, 미리 정한 심볼 사용)
+ * asm      : 파싱 후 pass1, pass2를 파일 없이 메모리에서 수행
+ * libFuzzer: clang++ -g -O1 -fsanitize=fuzzer,address -DSICASM_FUZZER termProject.cpp
+ *            (대상은 SICASM_FUZZ_TARGET 환경 변수, 기본 asm. 저장소의 .asm 파일을 초기 corpus로 사용)
+ * libFuzzer가 없으면 -F 실행기를 사용한다. (runFuzzDriver)
+ */
+enum FuzzTarget { FUZZ_PARSE, FUZZ_CONSTANT, FUZZ_EXPR, FUZZ_ASM };
+
+bool parseFuzzTarget(const string &name, FuzzTarget &t) {
+    if (name == "parse") t = FUZZ_PARSE;
+    else if (name == "constant") t = FUZZ_CONSTANT;
+    else if (name == "expr") t = FUZZ_EXPR;
+    else if (name == "asm") t = FUZZ_ASM;
+    else return false;
+    return true;
+}
+
+// optab.txt가 없으면 최소한의 OPTAB을 채우고, expr 대상은 두 블록에 걸친 심볼을 미리 정의
+void fuzzSetup(FuzzTarget t) {
+    if (!loadOptab("optab.txt")) {
+        static const pair<const char*, int> ops[] = {{"LDA",0x00},{"LDX",0x04},{"LDL",0x08},{"STA",0x0C},{"STX",0x10},
+            {"ADD",0x18},{"COMP",0x28},{"TIX",0x2C},{"JEQ",0x30},{"J",0x3C},{"JSUB",0x48},{"RSUB",0x4C},{"LDCH",0x50},
+            {"STCH",0x54},{"LDB",0x68},{"LDT",0x74},{"ADDR",0x90},{"COMPR",0xA0},{"CLEAR",0xB4},{"TIXR",0xB8},{"FIX",0xC4}};
+        for (auto &e : ops) OPTAB[e.first] = OptEntry{e.first, (uint8_t)e.second};
+    }
+    if (t == FUZZ_EXPR) {
+        SYMTAB.clear(); BLOCKTAB.clear(); blockOrder.clear();
+        BLOCKTAB[startBlockName] = Block{startBlockName,0x100,0x100,0,true};
+        BLOCKTAB["CDATA"] = Block{"CDATA",0x40,0x40,0x100,true};
+        blockOrder = {startBlockName, "CDATA"};
+        SYMTAB["ALPHA"] = SymEntry{"ALPHA", 0x10, startBlockName, false};
+        SYMTAB["BETA"] = SymEntry{"BETA", 0x30, startBlockName, false};
+        SYMTAB["GAMMA"] = SymEntry{"GAMMA", 0x08, "CDATA", false};
+        SYMTAB["MAXLEN"] = SymEntry{"MAXLEN", 4096, startBlockName, true};
+    }
+}
+
+void runFuzzTarget(FuzzTarget t, const string &in) {
+    switch (t) {
+    case FUZZ_PARSE: { istringstream iss(in); parseSourceStream(iss); break; }
+    case FUZZ_CONSTANT: { bool ok; bytesFromConstant(in, ok); break; }
+    case FUZZ_EXPR: evalExpression(in, startBlockName, 0x20, 1); break;
+    case FUZZ_ASM: { istringstream iss(in); assignPass1(parseSourceStream(iss)); encodePass2(); break; }
+    }
+}
+
+#ifdef SICASM_FUZZER
+static FuzzTarget LIBFUZZER_TARGET = FUZZ_ASM;
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***) {
+    const char *name = getenv("SICASM_FUZZ_TARGET");
+    if (name && !parseFuzzTarget(name, LIBFUZZER_TARGET)) { cerr << "Unknown fuzz target: " << name << "\n"; exit(2); }
+    fuzzSetup(LIBFUZZER_TARGET);
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    runFuzzTarget(LIBFUZZER_TARGET, string((const char*)data, size));
+    return 0;
+}
+#else
+// 실행 중인 입력과 저장 디렉토리 (시그널 핸들러에서 사용)
+static const string *FUZZ_CURRENT = nullptr;
+static char FUZZ_ARTIFACT_DIR[PATH_MAX];
+
+// <dir>/<prefix>-<FNV-1a 16진수> 경로 생성 (핸들러에서도 쓰므로 snprintf/malloc 없이)
+static void fuzzArtifactPath(char *out, size_t cap, const char *prefix, const string &in) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : in) { h ^= c; h *= 1099511628211ULL; }
+    size_t n = 0;
+    for (const char *p = FUZZ_ARTIFACT_DIR; *p && n + 1 < cap; ++p) out[n++] = *p;
+    if (n + 1 < cap) out[n++] = '/';
+    for (const char *p = prefix; *p && n + 1 < cap; ++p) out[n++] = *p;
+    if (n + 1 < cap) out[n++] = '-';
+    for (int i = 15; i >= 0 && n + 1 < cap; --i) out[n++] = "0123456789abcdef"[(h >> (i * 4)) & 0xF];
+    out[n] = '\0';
+}
+
+static bool fuzzSaveArtifact(const char *prefix, const string &in) {
+    char path[PATH_MAX + 64];
+    fuzzArtifactPath(path, sizeof(path), prefix, in);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool ok = write(fd, in.data(), in.size()) == (ssize_t)in.size();
+    close(fd);
+    return ok;
+}
+
+// 입력 처리 중 죽으면 입력을 crash-*로 남기고 같은 시그널로 종료
+static void fuzzCrashHandler(int sig) {
+    if (FUZZ_CURRENT && fuzzSaveArtifact("crash", *FUZZ_CURRENT)) {
+        const char msg[] = "fuzz: crashing input saved\n";
+        if (write(STDERR_FILENO, msg, sizeof(msg) - 1) < 0) {}
+    }
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+// 파일 또는 디렉토리 안의 일반 파일을 읽어 corpus에 추가
+static void fuzzLoadInputs(const string &path, vector<pair<string,string>> &corpus) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) { cerr << "Cannot open " << path << "\n"; return; }
+    if (S_ISDIR(st.st_mode)) {
+        DIR *d = opendir(path.c_str());
+        if (!d) return;
+        vector<string> names;
+        while (dirent *e = readdir(d)) if (e->d_name[0] != '.') names.push_back(e->d_name);
+        closedir(d);
+        sort(names.begin(), names.end());
+        for (auto &n : names) {
+            string p = path + "/" + n;
+            if (stat(p.c_str(), &st) == 0 && S_ISREG(st.st_mode)) fuzzLoadInputs(p, corpus);
+        }
+        return;
+    }
+    ifstream ifs(path, ios::binary);
+    corpus.push_back({path, string(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>())});
+}
+
+// 어셈블러 문법에 맞춘 토큰을 섞어 입력을 1~4번 변형
+static string fuzzMutate(const string &in, const vector<pair<string,string>> &corpus, mt19937_64 &rng) {
+    static const char *dict[] = {" ", "\t", "\n", ".", ",X", "'", "=", "#", "@", "+", "-", "*", "C'", "X'", "=C'EOF'",
+        "=X'05'", "0", "4096", "99999999999999999999", "-2147483649", "START", "END", "BYTE", "WORD", "RESB", "RESW",
+        "EQU", "ORG", "LTORG", "USE", "BASE", "NOBASE", "CSECT", "EXTDEF", "EXTREF", "LDA", "+JSUB", "CLEAR", "RSUB"};
+    const size_t maxLen = 1 << 16;
+    string s = in;
+    int ops = 1 + (int)(rng() % 4);
+    for (int k = 0; k < ops; ++k) {
+        size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+        switch (rng() % 5) {
+        case 0: if (!s.empty() && pos < s.size()) s[pos] = (char)(rng() % 256); break;
+        case 1: s.insert(pos, dict[rng() % (sizeof(dict) / sizeof(dict[0]))]); break;
+        case 2: if (pos < s.size()) s.erase(pos, 1 + rng() % min<size_t>(16, s.size() - pos)); break;
+        case 3: if (pos < s.size()) { size_t n = 1 + rng() % min<size_t>(64, s.size() - pos); s.insert(pos, s.substr(pos, n)); } break;
+        default: {
+            const string &o = corpus[rng() % corpus.size()].second;
+            if (o.empty()) break;
+            size_t from = rng() % o.size(), n = 1 + rng() % min<size_t>(256, o.size() - from);
+            s.insert(pos, o, from, n);
+        }
+        }
+        if (s.size() > maxLen) s.resize(maxLen);
+    }
+    return s;
+}
+
+/**
+ * libFuzzer 없이 fuzz 대상을 실행 (-F 대상)
+ * termProject -F 대상 [-n 변형횟수] [-s seed] [-A 저장디렉토리] [-W 느린입력ms] 입력파일|디렉토리...
+ * corpus를 한 번씩 재생해 초당 입력 수와 처리량을 재고, -n이 있으면 변형한 입력을 추가로 실행한다.
+ * 죽은 입력(시그널, 처리되지 않은 예외)은 crash-*, 한도보다 느린 입력은 slow-*로 저장 디렉토리에 남는다.
+ * 저장 디렉토리를 다음 실행의 입력으로 넘기면 그대로 회귀 검사가 된다.
+ */
+int runFuzzDriver(const string &targetName, const vector<string> &args) {
+    FuzzTarget target;
+    if (!parseFuzzTarget(targetName, target)) { cerr << "Unknown fuzz target: " << targetName << " (parse|constant|expr|asm)\n"; return 2; }
+    long mutations = 0;
+    uint64_t seed = 1;
+    string artifactDir = "fuzz-artifacts";
+    double slowSec = 0.1;
+    vector<pair<string,string>> corpus;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const string &a = args[i];
+        if (a == "-n" && i + 1 < args.size()) mutations = atol(args[++i].c_str());
+        else if (a == "-s" && i + 1 < args.size()) seed = strtoull(args[++i].c_str(), nullptr, 0);
+        else if (a == "-A" && i + 1 < args.size()) artifactDir = args[++i];
+        else if (a == "-W" && i + 1 < args.size()) slowSec = atof(args[++i].c_str()) / 1000.0;
+        else fuzzLoadInputs(a, corpus);
+    }
+    if (corpus.empty()) corpus.push_back({"(empty)", ""});
+    mkdir(artifactDir.c_str(), 0755);
+    snprintf(FUZZ_ARTIFACT_DIR, sizeof(FUZZ_ARTIFACT_DIR), "%s", artifactDir.c_str());
+    fuzzSetup(target);
+    for (int sig : {SIGSEGV, SIGABRT, SIGFPE, SIGBUS, SIGILL}) signal(sig, fuzzCrashHandler);
+
+    size_t crashes = 0, slow = 0;
+    double slowest = 0; string slowestName;
+    // 입력 하나 실행: 경과 시간 반환, 예외는 crash로 기록
+    auto runOne = [&](const string &name, const string &in) {
+        FUZZ_CURRENT = &in;
+        auto t0 = chrono::steady_clock::now();
+        try { runFuzzTarget(target, in); }
+        catch (const exception &e) {
+            ++crashes;
+            cerr << "fuzz: uncaught exception on " << name << ": " << e.what() << "\n";
+            fuzzSaveArtifact("crash", in);
+        }
+        double dt = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        FUZZ_CURRENT = nullptr;
+        if (dt > slowest) { slowest = dt; slowestName = name; }
+        if (dt > slowSec) { ++slow; fuzzSaveArtifact("slow", in); }
+        return dt;
+    };
+    auto report = [](const char *label, size_t runs, size_t bytes, double sec) {
+        cout << left << setw(9) << label << right << setw(10) << runs << " run(s), " << fixed << setprecision(4) << sec << " s, "
+             << setprecision(1) << (sec > 0 ? runs / sec : 0.0) << " inputs/s, "
+             << setprecision(2) << (sec > 0 ? bytes / sec / 1e6 : 0.0) << " MB/s\n";
+        cout.unsetf(ios::floatfield);
+    };
+
+    streambuf *screen = cout.rdbuf(nullptr);
+    size_t corpusBytes = 0; double corpusSec = 0;
+    for (auto &c : corpus) { corpusBytes += c.second.size(); corpusSec += runOne(c.first, c.second); }
+    mt19937_64 rng(seed);
+    size_t mutBytes = 0; double mutSec = 0;
+    for (long k = 0; k < mutations; ++k) {
+        string in = fuzzMutate(corpus[rng() % corpus.size()].second, corpus, rng);
+        mutBytes += in.size();
+        mutSec += runOne("mutation #" + to_string(k), in);
+    }
+    cout.rdbuf(screen);
+    cout.clear();
+
+    cout << "=== fuzz target " << targetName << ": " << corpus.size() << " input(s), " << corpusBytes << " bytes ===\n";
+    report("corpus", corpus.size(), corpusBytes, corpusSec);
+    if (mutations > 0) report("mutated", (size_t)mutations, mutBytes, mutSec);
+    cout << "slowest: " << fixed << setprecision(6) << slowest << " s (" << slowestName << ")\n";
+    cout.unsetf(ios::floatfield);
+    cout << "saved: " << crashes << " crash(es), " << slow << " slow input(s) in " << artifactDir << "\n";
+    return crashes ? 1 : 0;
+}
+#endif
+
+// ---------- benchmark ----------
+/**
+ * 단계별 시간 측정 (-B 반복횟수)
+ * 소스마다 parse, pass1, pass2(object code 생성), 출력 파일 작성을 따로 재고
+ * 가장 빠른 회차의 시간과 초당 소스 줄 수, 최대 RSS를 출력한다.
+ * 출력 파일은 실제로 작성하지만 화면 출력(레코드, PASS 메시지)은 버린다.
+ * 큰 입력은 workloadGen으로 만든다. (예: workloadGen -n 1000000 -o big.asm)
+ * instrJson이 있으면 소스마다 마지막 회차의 계측 결과를 JSON으로 덧붙인다.
+ */
+int runBenchmark(const vector<string> &sources, int reps, const string &instrJson) {
+    static const char *names[] = {"parse", "pass1", "pass2", "output", "total"};
+    int rc = 0;
+    for (auto &src : sources) {
+        double best[5];
+        for (double &b : best) b = numeric_limits<double>::max();
+        size_t lines = 0;
+        for (int r = 0; r < reps; ++r) {
+            resetInstrumentation();
+            streambuf *screen = cout.rdbuf(nullptr);
+            auto t0 = chrono::steady_clock::now();
+            vector<IntLine> parsed = parseSourceFile(src);
+            auto t1 = chrono::steady_clock::now();
+            lines = parsed.size();
+            assignPass1(parsed);
+            auto t2 = chrono::steady_clock::now();
+            encodePass2();
+            auto t3 = chrono::steady_clock::now();
+            writePass1Files();
+            writePass2Files();
+            auto t4 = chrono::steady_clock::now();
+            cout.rdbuf(screen);
+            cout.clear();
+            double t[5] = {chrono::duration<double>(t1 - t0).count(), chrono::duration<double>(t2 - t1).count(),
+                           chrono::duration<double>(t3 - t2).count(), chrono::duration<double>(t4 - t3).count(),
+                           chrono::duration<double>(t4 - t0).count()};
+            for (int k = 0; k < 5; ++k) best[k] = min(best[k], t[k]);
+        }
+        if (lines == 0) { cerr << "No lines in " << src << "\n"; rc = 1; continue; }
+        if (INSTR_ENABLED) writeInstrumentationJson(instrJson, src);
+        struct rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+        cout << "=== benchmark: " << src << " (" << lines << " lines, best of " << reps << ") ===\n";
+        for (int k = 0; k < 5; ++k) {
+            cout << left << setw(8) << names[k] << right << fixed << setprecision(6) << setw(12) << best[k] << " s"
+                 << setprecision(0) << setw(14) << (best[k] > 0 ? lines / best[k] : 0.0) << " lines/s\n";
+        }
+        cout << "errors: " << ERRORS.size() << ", peak RSS: " << ru.ru_maxrss << " KB\n";
+        cout.unsetf(ios::floatfield);
+        if (!ERRORS.empty()) rc = 1;
+    }
+    return rc;
+}
+
 // ---------- main ----------
+#ifndef SICASM_FUZZER
 int main(int argc, char** argv) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
     cout << "\nSIC/XE 2-pass assembler\n";
+    // 사용법: termProject [-j 워커수] [-O 출력디렉토리] [-m] [-P 초] [-L CPU초] [소스...]
+    //        termProject -B 반복횟수 소스...                  (단계별 시간 측정)
+    //        termProject -F 대상 [-n 변형횟수] [-A 저장디렉토리] 입력...  (fuzz 대상 실행, runFuzzDriver 참고)
+    //        termProject -S 소켓 [-j 워커수] [-T 스레드수]     (daemon)
+    //        termProject [-C 소켓] 소스                      (daemon에 맡김, SICASM_SOCKET 환경 변수로도 지정)
+    // -J 파일: 단계별 시간과 카운터를 JSON 한 줄로 파일에 덧붙임 (단일 소스, -B)
+    // 소스가 여러 개이거나 -j가 주어지면 worker pool로 어셈블 (-m: 결과를 공유 메모리로 전달, -L: 작업당 CPU 시간 한도)
+    // 실행 중 SIGUSR1을 보내면 진행 상황을 stderr에 출력 (-P: 주기적으로 출력)
+    vector<string> sources;
+    string outRoot = ".";
+    int nWorkers = 0;
+    bool sharedMem = false;
+    int progressSec = 0;
+    string daemonSocket, clientSocket;
+    int daemonThreads = 4;
+    int benchReps = 0;
+    string instrJson;
+    if (argc >= 3 && string(argv[1]) == "-F") return runFuzzDriver(argv[2], vector<string>(argv + 3, argv + argc));
+    if (getenv("SICASM_SOCKET")) clientSocket = getenv("SICASM_SOCKET");
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "-j" && i + 1 < argc) nWorkers = atoi(argv[++i]);
+        else if (a == "-O" && i + 1 < argc) outRoot = argv[++i];
+        else if (a == "-m") sharedMem = true;
+        else if (a == "-P" && i + 1 < argc) progressSec = atoi(argv[++i]);
+        else if (a == "-S" && i + 1 < argc) daemonSocket = argv[++i];
+        else if (a == "-L" && i + 1 < argc) CPU_BUDGET_SEC = atoi(argv[++i]);
+        else if (a == "-T" && i + 1 < argc) daemonThreads = atoi(argv[++i]);
+        else if (a == "-C" && i + 1 < argc) clientSocket = argv[++i];
+        else if (a == "-B" && i + 1 < argc) benchReps = atoi(argv[++i]);
+        else if (a == "-J" && i + 1 < argc) instrJson = argv[++i];
+        else sources.push_back(a);
+    }
+    if (!daemonSocket.empty()) {
+        if (!loadOptab("optab.txt")) { cerr << "Failed to load optab.txt\n"; return 2; }
+        if (nWorkers <= 0) nWorkers = max(1u, thread::hardware_concurrency());
+        return runDaemon(daemonSocket, nWorkers, daemonThreads);
+    }
     string src;
-    if (argc >= 2) src = argv[1];
+    if (!sources.empty()) src = sources[0];
     else { 
         cout << "Enter source filename: " << flush; 
         if (!getline(cin, src)) { cerr << "No input\n"; return 1; } 
@@ -977,15 +2640,32 @@ int main(int argc, char** argv) {
         if (src.empty()) { cerr << "Empty filename\n"; return 1; } 
     }
 
+    // daemon이 떠 있으면 맡기고, 연결할 수 없으면 직접 어셈블
+    if (!clientSocket.empty() && sources.size() <= 1 && nWorkers == 0 && !sharedMem && benchReps == 0) {
+        int rc = runClient(clientSocket, src);
+        if (rc >= 0) return rc;
+    }
+
     if (!loadOptab("optab.txt")) { cerr << "Failed to load optab.txt\n"; return 2; }
+    installStatsSignals(progressSec);
+    INSTR_ENABLED = !instrJson.empty();
+    if (benchReps > 0) return runBenchmark(sources.empty() ? vector<string>{src} : sources, benchReps, instrJson);
+
+    if (sources.size() > 1 || nWorkers > 0 || sharedMem) {
+        if (nWorkers <= 0) nWorkers = max(1u, thread::hardware_concurrency());
+        return runFarm(sources.empty() ? vector<string>{src} : sources, outRoot, nWorkers, sharedMem);
+    }
     
     BLOCKTAB.clear(); 
     blockOrder.clear(); 
     BLOCKTAB[startBlockName] = Block{startBlockName,0,0,0,true}; 
     blockOrder.push_back(startBlockName);
     
+    resetInstrumentation();
     doPass1(src);
     doPass2(src);
+    if (INSTR_ENABLED) writeInstrumentationJson(instrJson, src);
     
     return 0;
 }
+#endif
@@ -29,7 +29,7 @@ static inline string hexPad(uint64_t v, int width) {
 static inline int hexStrToInt(const string &s) {
     string t = s;
     if (t.size() >= 2 && t[0] == '0' && (t[1]=='x' || t[1]=='X')) t = t.substr(2);
-    int v; stringstream ss;
+    int v = 0; stringstream ss; // 변환에 실패하면 0
     ss << hex << t;
     ss >> v;
     return v;
@@ -0,0 +1,301 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+using namespace std;
+
+/**
+ * 어셈블러 성능 측정용 SIC/XE 소스 생성기
+ * 항상 오류 없이 어셈블되는 프로그램을 만든다. (termProject로 어셈블하면 Errors/Warnings가 없어야 한다)
+ *
+ * 프로그램은 "덩어리(chunk)"를 이어 붙여 만든다. 덩어리 하나는 한 블록 안에 연속으로 놓이므로
+ * 덩어리 안의 주소 차이는 생성기가 미리 알 수 있고, Format 3 참조는 모두 PC/BASE 상대 범위 안에 둔다.
+ *     USE 블록 / [+LDB #BUF, BASE BUF] / 명령어 본문 / LTORG / 데이터(WORD, RESW) / [BUF RESB, 그 뒤 데이터]
+ *     / [ORG로 겹쳐 놓은 필드] / EQU
+ * - 리터럴은 덩어리마다 새 값을 쓰고(덩어리 안에서만 재사용 -> 중복 제거) 덩어리 끝의 LTORG에 배치한다.
+ * - Format 4 참조 대상 주소는 20비트이므로 섹션이 1MB를 넘기 전에 CSECT로 새 제어 섹션을 시작한다.
+ */
+struct GenConfig {
+    uint64_t lines = 10000;          // 만들 줄 수 (대략, 덩어리 단위로 끊음)
+    int weight[4] = {5, 15, 65, 15}; // Format 1~4 비율
+    int blocks = 3;                  // USE 블록 수 (1이면 USE 없음)
+    int chunk = 64;                  // 덩어리당 명령어 수 (= LTORG 간격)
+    double literal = 0.10;           // Format 3 명령어 중 리터럴을 쓰는 비율
+    double reuse = 0.30;             // 리터럴을 덩어리 안에서 다시 쓰는 비율 (중복 제거 대상)
+    double base = 0.25;              // BASE 상대 주소를 쓰는 덩어리 비율
+    double org = 0.20;               // ORG 필드를 두는 덩어리 비율
+    int equ = 2;                     // 덩어리당 EQU 수
+    uint64_t seed = 1;
+};
+
+static const char *F1_OPS[] = {"FIX", "FLOAT", "NORM", "HIO", "SIO", "TIO"};
+static const char *F2_OPS[] = {"ADDR", "COMPR", "SUBR", "MULR", "RMO"};
+static const char *F2_REGS[] = {"A", "X", "L", "B", "S", "T"};
+static const char *MEM_OPS[] = {"LDA", "LDX", "LDS", "LDT", "STA", "STX", "ADD", "SUB", "COMP", "AND", "OR", "MUL", "TIX"};
+static const char *JMP_OPS[] = {"J", "JEQ", "JLT", "JGT"};
+static const uint32_t SECTION_LIMIT = 0xC0000; // 이보다 커지면 새 CSECT
+
+class Generator {
+public:
+    Generator(const GenConfig &c, ostream &o) : cfg(c), out(o), rng(c.seed) {}
+
+    void run() {
+        emit("SYNTH", "START", "0");
+        emit("FIRST", "LDA", "#0");
+        while (lineCount < cfg.lines) {
+            if (sectionBytes > SECTION_LIMIT) newSection();
+            genChunk();
+        }
+        emit("", "END", "FIRST");
+    }
+
+    uint64_t linesWritten() const { return lineCount; }
+
+private:
+    const GenConfig &cfg;
+    ostream &out;
+    mt19937_64 rng;
+    uint64_t lineCount = 0;
+    uint64_t nextId = 0;           // 레이블 번호
+    uint64_t nextLiteral = 1;      // 리터럴 값 (덩어리마다 새 값)
+    uint32_t sectionBytes = 0;
+    int sections = 1;
+    vector<string> sectionLabels;  // 현재 섹션의 코드 레이블 (Format 4 대상)
+    vector<string> absSymbols;     // 현재 섹션의 절대값 EQU 심볼 (값 <= 0xFFF)
+
+    int pick(int n) { return (int)(rng() % (uint64_t)n); }
+    bool chance(double p) { return uniform_real_distribution<double>(0.0, 1.0)(rng) < p; }
+    string label(char prefix) { return string(1, prefix) + to_string(++nextId); }
+
+    void emit(const string &lab, const string &op, const string &operand) {
+        out << left << setw(8) << lab << " " << setw(7) << op;
+        if (!operand.empty()) out << " " << operand;
+        out << "\n";
+        ++lineCount;
+    }
+
+    void newSection() {
+        emit("SEC" + to_string(++sections), "CSECT", "");
+        sectionBytes = 0;
+        sectionLabels.clear();
+        absSymbols.clear();
+    }
+
+    string newLiteral(vector<pair<string,int>> &used) {
+        if (!used.empty() && chance(cfg.reuse)) return used[pick((int)used.size())].first;
+        uint64_t v = (nextLiteral++) & 0xFFFFFF;
+        string lit;
+        int len = 3;
+        switch (pick(3)) {
+            case 0: { stringstream ss; ss << "=X'" << uppercase << hex << setw(6) << setfill('0') << v << "'"; lit = ss.str(); break; }
+            case 1: lit = "=" + to_string(v); break;
+            default: { string s = to_string(v); lit = "=C'" + s + "'"; len = (int)s.size(); break; }
+        }
+        used.push_back({lit, len});
+        return lit;
+    }
+
+    /**
+     * 덩어리 하나 생성
+     * 본문이 참조하는 데이터 레이블, EQU 이름은 본문보다 먼저 정해 둔다.
+     */
+    void genChunk() {
+        if (cfg.blocks > 1) {
+            int b = pick(cfg.blocks);
+            emit("", "USE", b == 0 ? "" : "B" + to_string(b));
+        }
+        bool useBase = chance(cfg.base);
+        bool useOrg = chance(cfg.org);
+        vector<string> data;
+        for (int i = 0; i < 4; ++i) data.push_back(label('D'));
+        string buf = label('V'), far = label('W');
+        string orgBase = label('O');
+        vector<string> orgFields = {label('F'), label('F')};
+        vector<string> equs;
+        for (int i = 0; i < cfg.equ; ++i) equs.push_back(label('E'));
+        uint32_t bytes = 0;
+
+        if (useBase) {
+            emit("", "+LDB", "#" + buf);
+            emit("", "BASE", buf);
+            bytes += 4;
+        }
+
+        // 본문: 레이블은 대략 네 줄에 하나
+        int n = cfg.chunk;
+        vector<string> bodyLabels(n);
+        for (int i = 0; i < n; ++i) if (i == 0 || pick(4) == 0) bodyLabels[i] = label('L');
+        vector<string> jumpTargets;
+        for (auto &l : bodyLabels) if (!l.empty()) jumpTargets.push_back(l);
+
+        vector<pair<string,int>> literals;
+        int total = cfg.weight[0] + cfg.weight[1] + cfg.weight[2] + cfg.weight[3];
+        for (int i = 0; i < n; ++i) {
+            int w = pick(total), fmt = 0;
+            while (w >= cfg.weight[fmt]) w -= cfg.weight[fmt++];
+            const string &lab = bodyLabels[i];
+            if (fmt == 0) {
+                emit(lab, F1_OPS[pick(6)], "");
+                bytes += 1;
+            } else if (fmt == 1) {
+                int k = pick(7);
+                if (k == 5) emit(lab, "CLEAR", F2_REGS[pick(6)]);
+                else if (k == 6) emit(lab, pick(2) ? "SHIFTL" : "SHIFTR", string(F2_REGS[pick(6)]) + "," + to_string(1 + pick(16)));
+                else emit(lab, F2_OPS[pick(5)], string(F2_REGS[pick(6)]) + "," + F2_REGS[pick(6)]);
+                bytes += 2;
+            } else if (fmt == 2) {
+                string op = MEM_OPS[pick(13)], operand;
+                int k = pick(100);
+                if (chance(cfg.literal)) {
+                    if (op.compare(0, 2, "ST") == 0) op = "LDA"; // 저장 명령어에는 리터럴을 쓰지 않음
+                    operand = newLiteral(literals);
+                } else if (k < 45) operand = data[pick(4)];
+                else if (k < 55) operand = data[pick(4)] + ",X";
+                else if (k < 60) operand = "@" + data[pick(4)];
+                else if (k < 70) operand = "#" + to_string(pick(4096));
+                else if (k < 75 && !absSymbols.empty()) operand = "#" + absSymbols[pick((int)absSymbols.size())];
+                else if (k < 80 && useOrg) operand = orgFields[pick(2)];
+                else if (k < 85 && useBase) operand = far;
+                else if (k < 90) { op = "LDCH"; operand = buf + ",X"; }
+                else { op = JMP_OPS[pick(4)]; operand = jumpTargets[pick((int)jumpTargets.size())]; }
+                emit(lab, op, operand);
+                bytes += 3;
+            } else {
+                if (!sectionLabels.empty() && pick(3) != 0) emit(lab, pick(2) ? "+JSUB" : "+LDA", sectionLabels[pick((int)sectionLabels.size())]);
+                else emit(lab, "+LDT", "#" + to_string(4096 + pick(0xFF000)));
+                bytes += 4;
+            }
+        }
+        emit("", "RSUB", "");
+        bytes += 3;
+        if (!literals.empty()) {
+            emit("", "LTORG", "");
+            for (auto &l : literals) bytes += (uint32_t)l.second; // 중복은 어차피 한 번만 배치되므로 넉넉한 추정치
+        }
+
+        // 데이터
+        emit(data[0], "WORD", to_string(pick(1 << 20)));
+        emit(data[1], "WORD", to_string(pick(1 << 20)));
+        emit(data[2], "RESW", "1");
+        emit(data[3], "WORD", to_string(pick(1 << 20)));
+        uint32_t bufSize = useBase ? 2100 + (uint32_t)pick(1900) : 16 + (uint32_t)pick(48);
+        emit(buf, "RESB", to_string(bufSize));
+        bytes += 12 + bufSize;
+        if (useBase) { emit(far, "RESW", "1"); bytes += 3; }
+        if (useOrg) {
+            emit(orgBase, "RESB", "30");
+            emit("", "ORG", orgBase);
+            emit(orgFields[0], "RESW", "1");
+            emit(orgFields[1], "RESW", "1");
+            emit("", "ORG", orgBase + "+30");
+            bytes += 30;
+        }
+        for (size_t i = 0; i < equs.size(); ++i) {
+            if (i % 2 == 0) emit(equs[i], "EQU", data[3] + "-" + data[0]);        // 절대값 (9)
+            else emit(equs[i], "EQU", to_string(pick(2048)) + "+" + to_string(pick(2048)));
+            absSymbols.push_back(equs[i]);
+        }
+        if (absSymbols.size() > 64) absSymbols.erase(absSymbols.begin(), absSymbols.begin() + 32);
+
+        for (auto &l : jumpTargets) sectionLabels.push_back(l);
+        if (sectionLabels.size() > 4096) sectionLabels.erase(sectionLabels.begin(), sectionLabels.begin() + 2048);
+        sectionBytes += bytes;
+    }
+};
+
+// 옵션 값 파싱 (예외 없이): 10진수 정수 전체가 [lo, hi] 안이면 true
+static bool parseULong(const string &s, uint64_t lo, uint64_t hi, uint64_t &out) {
+    if (s.empty() || s[0] == '-' || s[0] == '+') return false;
+    char *end = nullptr;
+    errno = 0;
+    unsigned long long v = strtoull(s.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE || v < lo || v > hi) return false;
+    out = v;
+    return true;
+}
+static bool parseInt(const string &s, int lo, int hi, int &out) {
+    uint64_t v;
+    if (!parseULong(s, (uint64_t)max(lo, 0), (uint64_t)hi, v)) return false;
+    out = (int)v;
+    return true;
+}
+// 비율 (0 ~ 1)
+static bool parseRatio(const string &s, double &out) {
+    if (s.empty()) return false;
+    char *end = nullptr;
+    errno = 0;
+    double v = strtod(s.c_str(), &end);
+    if (*end != '\0' || errno == ERANGE || !(v >= 0 && v <= 1)) return false;
+    out = v;
+    return true;
+}
+
+/**
+ * 사용법: workloadGen [-n 줄수] [-f F1,F2,F3,F4] [-u 블록수] [-c 덩어리크기] [-l 리터럴비율] [-r 재사용비율]
+ *                     [-b BASE비율] [-g ORG비율] [-e EQU수] [-s 시드] [-o 출력파일]
+ * -n: 대략적인 줄 수 (1K ~ 10M)
+ * -f: Format 1~4 명령어 비율 (기본 5,15,65,15)
+ * -u: USE 블록 수 (기본 3)
+ * -c: 덩어리당 명령어 수, 곧 LTORG 간격 (8 ~ 200, 기본 64)
+ * -l: Format 3 명령어 중 리터럴 비율 (기본 0.1), -r: 그중 덩어리 안에서 다시 쓰는 비율 (기본 0.3)
+ * -b: BASE 상대 주소를 쓰는 덩어리 비율 (기본 0.25), -g: ORG를 쓰는 덩어리 비율 (기본 0.2)
+ *     비율은 모두 0 ~ 1
+ * -e: 덩어리당 EQU 수 (기본 2)
+ * 출력 파일을 주지 않으면 표준 출력으로 쓴다.
+ * 예: workloadGen -n 1000000 -o big.asm && termProject -B 3 big.asm
+ */
+int main(int argc, char **argv) {
+    ios::sync_with_stdio(false);
+    GenConfig cfg;
+    string outFile;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (i + 1 >= argc) { cerr << "Missing value for " << a << "\n"; return 2; }
+        string v = argv[++i];
+        bool ok = true;
+        if (a == "-n") ok = parseULong(v, 1000, 10000000, cfg.lines);
+        else if (a == "-f") {
+            char c;
+            istringstream iss(v);
+            if (!(iss >> cfg.weight[0] >> c >> cfg.weight[1] >> c >> cfg.weight[2] >> c >> cfg.weight[3])) { cerr << "Bad format mix " << v << "\n"; return 2; }
+        }
+        else if (a == "-u") ok = parseInt(v, 1, 100, cfg.blocks);
+        else if (a == "-c") ok = parseInt(v, 0, INT_MAX, cfg.chunk);
+        else if (a == "-l") ok = parseRatio(v, cfg.literal);
+        else if (a == "-r") ok = parseRatio(v, cfg.reuse);
+        else if (a == "-b") ok = parseRatio(v, cfg.base);
+        else if (a == "-g") ok = parseRatio(v, cfg.org);
+        else if (a == "-e") ok = parseInt(v, 0, 1000, cfg.equ);
+        else if (a == "-s") ok = parseULong(v, 0, UINT64_MAX, cfg.seed);
+        else if (a == "-o") outFile = v;
+        else { cerr << "Unknown option " << a << "\n"; return 2; }
+        if (!ok) { cerr << "Bad value for " << a << ": " << v << "\n"; return 2; }
+    }
+    // 덩어리가 너무 크면 Format 3 참조가 PC 상대 범위(2047)를 벗어날 수 있음
+    if (cfg.chunk < 8) cfg.chunk = 8;
+    if (cfg.chunk > 200) cfg.chunk = 200;
+    if (cfg.blocks < 1) cfg.blocks = 1;
+    if (cfg.equ < 0) cfg.equ = 0;
+    int total = 0;
+    for (int &w : cfg.weight) { if (w < 0) w = 0; total += w; }
+    if (total == 0) { cerr << "Format mix is all zero\n"; return 2; }
+
+    ofstream file;
+    if (!outFile.empty()) {
+        file.open(outFile);
+        if (!file) { cerr << "Cannot open " << outFile << "\n"; return 1; }
+    }
+    ostream &out = outFile.empty() ? cout : file;
+    Generator gen(cfg, out);
+    gen.run();
+    out.flush();
+    if (!outFile.empty()) cerr << "Wrote " << gen.linesWritten() << " lines to " << outFile << "\n";
+    return 0;
+}